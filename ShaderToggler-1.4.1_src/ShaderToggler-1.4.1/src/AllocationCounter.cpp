@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "AllocationCounter.h"
+
+#ifdef _DEBUG
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local uint32_t t_activeCounters = 0;
+	thread_local uint32_t t_allocationCount = 0;
+
+	void* allocateCounted(std::size_t size)
+	{
+		if (t_activeCounters > 0)
+		{
+			++t_allocationCount;
+		}
+
+		void* memory = std::malloc(size == 0 ? 1 : size);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+void* operator new(std::size_t size) { return allocateCounted(size); }
+void* operator new[](std::size_t size) { return allocateCounted(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace ShaderToggler
+{
+	ScopedAllocationCounter::ScopedAllocationCounter() : _countAtStart(t_allocationCount)
+	{
+		++t_activeCounters;
+	}
+
+
+	ScopedAllocationCounter::~ScopedAllocationCounter()
+	{
+		--t_activeCounters;
+	}
+
+
+	uint32_t ScopedAllocationCounter::getCount() const
+	{
+		return t_allocationCount - _countAtStart;
+	}
+}
+#endif
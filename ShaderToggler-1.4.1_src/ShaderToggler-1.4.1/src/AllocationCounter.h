@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+namespace ShaderToggler
+{
+	// Counts the heap allocations (operator new) made on the current thread while an instance is alive.
+	// Only debug builds replace operator new for this; in release builds the count is always 0.
+	// Used to check that the present, bind and draw hooks don't allocate once the configuration is stable.
+	class ScopedAllocationCounter
+	{
+	public:
+#ifdef _DEBUG
+		ScopedAllocationCounter();
+		~ScopedAllocationCounter();
+		uint32_t getCount() const;
+#else
+		ScopedAllocationCounter() = default;
+		uint32_t getCount() const { return 0; }
+#endif
+
+		ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+		ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+
+#ifdef _DEBUG
+	private:
+		uint32_t _countAtStart;
+#endif
+	};
+}
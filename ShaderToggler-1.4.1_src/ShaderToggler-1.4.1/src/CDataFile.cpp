@@ -34,7 +34,9 @@
 // IP_Address=127.0.0.1
 // MachineName=ADMIN
 //
+#ifdef _WIN32
 #include "stdafx.h"
+#endif
 #include <vector>
 #include <string>
 #include <ctype.h>
@@ -42,6 +44,7 @@
 #include <stdarg.h>
 #include <fstream>
 #include <float.h>
+#include <limits.h>
 #include <sstream>
 
 #ifdef WIN32
@@ -50,6 +53,8 @@
 
 #include "CDataFile.h"
 
+static const t_Str TrimChars = WhiteSpace + EqualIndicators;
+
 // Compatibility Defines ////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////
 #ifdef WIN32
@@ -57,6 +62,50 @@
   #define vsnprintf _vsnprintf
 #endif
 
+// The hash pack tool builds this file on its own, outside Windows.
+#ifndef _WIN32
+  #include <string.h>
+  #include <strings.h>
+  #define _snprintf_s(buf, size, ...)        snprintf(buf, size, __VA_ARGS__)
+  #define _vsnprintf_s(buf, size, fmt, args) vsnprintf(buf, size, fmt, args)
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+// Forces a written file's contents out to the disk, so the rename that puts it in place can't land before them.
+static bool CommitFile(const std::filesystem::path& fileName)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(fileName.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	const bool bFlushed = FlushFileBuffers(hFile) != FALSE;
+	CloseHandle(hFile);
+	return bFlushed;
+#else
+	const int fd = open(fileName.c_str(), O_WRONLY);
+	if (fd < 0)
+		return false;
+
+	const bool bFlushed = fsync(fd) == 0;
+	close(fd);
+	return bFlushed;
+#endif
+}
+
+// Puts a committed file in place of another; on Windows the move itself is flushed before it returns.
+static bool MoveFileOver(const std::filesystem::path& fromFileName, const std::filesystem::path& toFileName)
+{
+#ifdef _WIN32
+	return MoveFileExW(fromFileName.c_str(), toFileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+	std::error_code error;
+	std::filesystem::rename(fromFileName, toFileName, error);
+	return !error;
+#endif
+}
+
 
 // CDataFile
 // Our default contstructor.  If it can load the file, it will do so and populate
@@ -66,7 +115,8 @@ CDataFile::CDataFile(const std::filesystem::path& fileName)
 	m_bDirty = false;
 	m_szFileName = fileName;
 	m_Flags = (AUTOCREATE_SECTIONS | AUTOCREATE_KEYS);
-	m_Sections.push_back(*(new t_Section));
+	m_Sections.push_back(t_Section());
+	RebuildSectionIndex();
 
 	Load(m_szFileName);
 }
@@ -75,7 +125,8 @@ CDataFile::CDataFile()
 {
 	Clear();
 	m_Flags = (AUTOCREATE_SECTIONS | AUTOCREATE_KEYS);
-	m_Sections.push_back(*(new t_Section));
+	m_Sections.push_back(t_Section());
+	RebuildSectionIndex();
 }
 
 // ~CDataFile
@@ -92,7 +143,10 @@ void CDataFile::Clear()
 {
 	m_bDirty = false;
 	m_szFileName.clear();
+	m_szHeader.clear();
+	m_szFooter.clear();
 	m_Sections.clear();
+	m_SectionIndex.clear();
 }
 
 // SetFileName
@@ -109,84 +163,149 @@ void CDataFile::SetFileName(const std::filesystem::path& fileName)
 	m_szFileName = fileName;
 }
 
+// SetHeader / SetFooter
+// Text written verbatim before the first and after the last section by Save.
+void CDataFile::SetHeader(const t_Str& szHeader)
+{
+	m_szHeader = szHeader;
+}
+
+void CDataFile::SetFooter(const t_Str& szFooter)
+{
+	m_szFooter = szFooter;
+}
+
 // Load
 // Attempts to load in the text file. If successful it will populate the 
 // Section list with the key/value pairs found in the file. Note that comments
 // are saved so that they can be rewritten to the file later.
+// The file is read in one block and parsed in place, so there is no limit on
+// the length of a line.
 bool CDataFile::Load(const std::filesystem::path& fileName)
 {
 	// We dont want to create a new file here.  If it doesn't exist, just
 	// return false and report the failure.
-	fstream File(fileName, ios::in);
+	fstream File(fileName, ios::in | ios::binary);
 
-	if (File.is_open())
+	if (!File.is_open())
 	{
-		bool bDone = false;
-		bool bAutoKey = (m_Flags & AUTOCREATE_KEYS) == AUTOCREATE_KEYS;
-		bool bAutoSec = (m_Flags & AUTOCREATE_SECTIONS) == AUTOCREATE_SECTIONS;
+		Report(E_INFO, "[CDataFile::Load] Unable to open file. Does it exist?");
+		return false;
+	}
 
-		t_Str szLine;
-		t_Str szComment;
-		char buffer[MAX_BUFFER_LEN];
-		t_Section* pSection = GetSection("");
+	t_Str szBuffer;
 
-		// These need to be set, we'll restore the original values later.
-		m_Flags |= AUTOCREATE_KEYS;
-		m_Flags |= AUTOCREATE_SECTIONS;
+	File.seekg(0, ios::end);
+	const std::streamoff nSize = File.tellg();
+	File.seekg(0, ios::beg);
 
-		while (!bDone)
-		{
-			memset(buffer, 0, MAX_BUFFER_LEN);
-			File.getline(buffer, MAX_BUFFER_LEN);
+	if (nSize > 0)
+	{
+		szBuffer.resize(static_cast<size_t>(nSize));
+		File.read(szBuffer.data(), nSize);
+		szBuffer.resize(static_cast<size_t>(File.gcount()));
+	}
 
-			szLine = buffer;
-			Trim(szLine);
+	File.close();
 
-			bDone = (File.eof() || File.bad() || File.fail());
+	bool bAutoKey = (m_Flags & AUTOCREATE_KEYS) == AUTOCREATE_KEYS;
+	bool bAutoSec = (m_Flags & AUTOCREATE_SECTIONS) == AUTOCREATE_SECTIONS;
 
-			if (szLine.find_first_of(CommentIndicators) == 0)
-			{
-				szComment += "\n";
-				szComment += szLine;
-			}
-			else if (szLine.find_first_of('[') == 0) // new section
-			{
-				szLine.erase(0, 1);
-				szLine.erase(szLine.find_last_of(']'), 1);
+	// These need to be set, we'll restore the original values later.
+	m_Flags |= AUTOCREATE_KEYS;
+	m_Flags |= AUTOCREATE_SECTIONS;
 
-				CreateSection(szLine, szComment);
-				pSection = GetSection(szLine);
-				szComment = t_Str("");
-			}
-			else if (szLine.size() > 0) // we have a key, add this key/value pair
+	ParseBuffer(szBuffer);
+
+	// Restore the original flag values.
+	if (!bAutoKey)
+		m_Flags &= ~AUTOCREATE_KEYS;
+
+	if (!bAutoSec)
+		m_Flags &= ~AUTOCREATE_SECTIONS;
+
+	return true;
+}
+
+// ParseBuffer
+// Splits the loaded text into lines and tokenizes each one as a view into the
+// buffer; only section names, keys, values and comments that are kept get
+// copied. Follows the line rules of the original getline loop: lines are
+// trimmed, ';' or '#' starts a comment, '[' a section, and anything else is
+// split at the first '=' or ':' into a trimmed key and the remaining value.
+void CDataFile::ParseBuffer(std::string_view szData)
+{
+	// keys before the first section header go to the default section.
+	if (GetSection("") == NULL)
+		CreateSection("", "");
+
+	t_Str szComment;
+	size_t nSection = m_SectionIndex.find(std::string_view())->second;
+	size_t nPos = 0;
+
+	while (nPos < szData.size())
+	{
+		size_t nEnd = szData.find('\n', nPos);
+
+		if (nEnd == std::string_view::npos)
+			nEnd = szData.size();
+
+		std::string_view szLine = TrimView(szData.substr(nPos, nEnd - nPos));
+		nPos = nEnd + 1;
+
+		if (szLine.empty())
+			continue;
+
+		if (CommentIndicators.find(szLine.front()) != t_Str::npos)
+		{
+			szComment += "\n";
+			szComment.append(szLine);
+		}
+		else if (szLine.front() == '[') // new section
+		{
+			t_Str szName(szLine.substr(1));
+			size_t nClose = szName.find_last_of(']');
+
+			if (nClose != t_Str::npos)
+				szName.erase(nClose, 1);
+
+			CreateSection(szName, szComment);
+			nSection = m_SectionIndex.find(szName)->second;
+			szComment = t_Str("");
+		}
+		else // we have a key, add this key/value pair
+		{
+			size_t nDelim = szLine.find_first_of(EqualIndicators);
+			std::string_view szKey = TrimView(szLine.substr(0, nDelim));
+			std::string_view szValue = (nDelim == std::string_view::npos) ? std::string_view() : szLine.substr(nDelim + 1);
+
+			if (szKey.size() > 0 && szValue.size() > 0)
 			{
-				t_Str szKey = GetNextWord(szLine);
-				t_Str szValue = szLine;
+				t_Section& Section = m_Sections[nSection];
+				NameIndex::const_iterator k_pos = Section.KeyIndex.find(szKey);
 
-				if (szKey.size() > 0 && szValue.size() > 0)
+				if (k_pos != Section.KeyIndex.end())
 				{
-					SetValue(szKey, szValue, szComment, pSection->szName);
-					szComment = t_Str("");
+					Section.Keys[k_pos->second].szValue.assign(szValue);
+					Section.Keys[k_pos->second].szComment = szComment;
 				}
-			}
-		}
-
-		// Restore the original flag values.
-		if (!bAutoKey)
-			m_Flags &= ~AUTOCREATE_KEYS;
+				else
+				{
+					t_Key Key;
 
-		if (!bAutoSec)
-			m_Flags &= ~AUTOCREATE_SECTIONS;
-	}
-	else
-	{
-		Report(E_INFO, "[CDataFile::Load] Unable to open file. Does it exist?");
-		return false;
-	}
+					Key.szKey.assign(szKey);
+					Key.szValue.assign(szValue);
+					Key.szComment = szComment;
 
-	File.close();
+					Section.KeyIndex.emplace(Key.szKey, Section.Keys.size());
+					Section.Keys.push_back(std::move(Key));
+				}
 
-	return true;
+				m_bDirty = true;
+				szComment = t_Str("");
+			}
+		}
+	}
 }
 
 
@@ -194,6 +313,9 @@ bool CDataFile::Load(const std::filesystem::path& fileName)
 // Attempts to save the Section list and keys to the file. Note that if Load
 // was never called (the CDataFile object was created manually), then you
 // must set the m_szFileName variable before calling save.
+// Header, sections and footer go out in one pass to a temporary file next to
+// the target, which is flushed to the disk and then replaces it, so neither a
+// crash nor a power loss leaves a truncated file.
 bool CDataFile::Save()
 {
 	if (KeyCount() == 0 && SectionCount() == 0)
@@ -209,10 +331,15 @@ bool CDataFile::Save()
 		return false;
 	}
 
-	fstream File(m_szFileName, ios::out | ios::trunc);
+	std::filesystem::path szTempFileName = m_szFileName;
+	szTempFileName += ".tmp";
+
+	fstream File(szTempFileName, ios::out | ios::trunc | ios::binary);
 
 	if (File.is_open())
 	{
+		File.write(m_szHeader.data(), static_cast<std::streamsize>(m_szHeader.size()));
+
 		SectionItor s_pos;
 		KeyItor k_pos;
 		t_Section Section;
@@ -259,11 +386,28 @@ bool CDataFile::Save()
 		return false;
 	}
 
-	m_bDirty = false;
-
+	File.write(m_szFooter.data(), static_cast<std::streamsize>(m_szFooter.size()));
 	File.flush();
+	const bool bWritten = !File.fail();
 	File.close();
 
+	std::error_code error;
+	if (!bWritten || !CommitFile(szTempFileName))
+	{
+		std::filesystem::remove(szTempFileName, error);
+		Report(E_ERROR, "[CDataFile::Save] Unable to write file.");
+		return false;
+	}
+
+	if (!MoveFileOver(szTempFileName, m_szFileName))
+	{
+		std::filesystem::remove(szTempFileName, error);
+		Report(E_ERROR, "[CDataFile::Save] Unable to replace file.");
+		return false;
+	}
+
+	m_bDirty = false;
+
 	return true;
 }
 
@@ -271,23 +415,14 @@ bool CDataFile::Save()
 // Set the comment of a given key. Returns true if the key is not found.
 bool CDataFile::SetKeyComment(t_Str szKey, t_Str szComment, t_Str szSection)
 {
-	KeyItor k_pos;
-	t_Section* pSection;
+	t_Key* pKey = GetKey(szKey, szSection);
 
-	if ((pSection = GetSection(szSection)) == NULL)
+	if (pKey == NULL)
 		return false;
 
-	for (k_pos = pSection->Keys.begin(); k_pos != pSection->Keys.end(); k_pos++)
-	{
-		if (CompareNoCase((*k_pos).szKey, szKey) == 0)
-		{
-			(*k_pos).szComment = szComment;
-			m_bDirty = true;
-			return true;
-		}
-	}
-
-	return false;
+	pKey->szComment = szComment;
+	m_bDirty = true;
+	return true;
 }
 
 // SetSectionComment
@@ -295,19 +430,14 @@ bool CDataFile::SetKeyComment(t_Str szKey, t_Str szComment, t_Str szSection)
 // was not found.
 bool CDataFile::SetSectionComment(t_Str szSection, t_Str szComment)
 {
-	SectionItor s_pos;
+	t_Section* pSection = GetSection(szSection);
 
-	for (s_pos = m_Sections.begin(); s_pos != m_Sections.end(); s_pos++)
-	{
-		if (CompareNoCase((*s_pos).szName, szSection) == 0)
-		{
-			(*s_pos).szComment = szComment;
-			m_bDirty = true;
-			return true;
-		}
-	}
+	if (pSection == NULL)
+		return false;
 
-	return false;
+	pSection->szComment = szComment;
+	m_bDirty = true;
+	return true;
 }
 
 
@@ -337,15 +467,16 @@ bool CDataFile::SetValue(t_Str szKey, t_Str szValue, t_Str szComment, t_Str szSe
 	// is not t_Str("") then add the new key.
 	if (pKey == NULL && szValue.size() > 0 && (m_Flags & AUTOCREATE_KEYS))
 	{
-		pKey = new t_Key;
+		t_Key Key;
 
-		pKey->szKey = szKey;
-		pKey->szValue = szValue;
-		pKey->szComment = szComment;
+		Key.szKey = szKey;
+		Key.szValue = szValue;
+		Key.szComment = szComment;
 
 		m_bDirty = true;
 
-		pSection->Keys.push_back(*pKey);
+		pSection->KeyIndex.emplace(Key.szKey, pSection->Keys.size());
+		pSection->Keys.push_back(std::move(Key));
 
 		return true;
 	}
@@ -416,6 +547,13 @@ bool CDataFile::SetString(t_Str szKey, t_Str szValue, t_Str szComment, t_Str szS
 	return SetValue(szKey, szValue, szComment, szSection);
 }
 
+const KeyList* CDataFile::GetSectionKeys(const t_Str& szSection)
+{
+	t_Section* pSection = GetSection(szSection);
+
+	return (pSection == NULL) ? NULL : &pSection->Keys;
+}
+
 std::vector<uint32_t> CDataFile::GetArray(t_Str szKey, t_Str szSection)
 {
 	std::vector<uint32_t> result;
@@ -533,18 +671,14 @@ bool CDataFile::GetBool(t_Str szKey, t_Str szSection)
 // found or true when sucessfully deleted.
 bool CDataFile::DeleteSection(t_Str szSection)
 {
-	SectionItor s_pos;
+	NameIndex::const_iterator s_pos = m_SectionIndex.find(szSection);
 
-	for (s_pos = m_Sections.begin(); s_pos != m_Sections.end(); s_pos++)
-	{
-		if (CompareNoCase((*s_pos).szName, szSection) == 0)
-		{
-			m_Sections.erase(s_pos);
-			return true;
-		}
-	}
+	if (s_pos == m_SectionIndex.end())
+		return false;
 
-	return false;
+	m_Sections.erase(m_Sections.begin() + s_pos->second);
+	RebuildSectionIndex();
+	return true;
 }
 
 // DeleteKey
@@ -552,22 +686,19 @@ bool CDataFile::DeleteSection(t_Str szSection)
 // cannot be found or true when sucessfully deleted.
 bool CDataFile::DeleteKey(t_Str szKey, t_Str szFromSection)
 {
-	KeyItor k_pos;
 	t_Section* pSection;
 
 	if ((pSection = GetSection(szFromSection)) == NULL)
 		return false;
 
-	for (k_pos = pSection->Keys.begin(); k_pos != pSection->Keys.end(); k_pos++)
-	{
-		if (CompareNoCase((*k_pos).szKey, szKey) == 0)
-		{
-			pSection->Keys.erase(k_pos);
-			return true;
-		}
-	}
+	NameIndex::const_iterator k_pos = pSection->KeyIndex.find(szKey);
 
-	return false;
+	if (k_pos == pSection->KeyIndex.end())
+		return false;
+
+	pSection->Keys.erase(pSection->Keys.begin() + k_pos->second);
+	pSection->RebuildKeyIndex();
+	return true;
 }
 
 // CreateKey
@@ -606,11 +737,12 @@ bool CDataFile::CreateSection(t_Str szSection, t_Str szComment)
 		return false;
 	}
 
-	pSection = new t_Section;
+	t_Section Section;
 
-	pSection->szName = szSection;
-	pSection->szComment = szComment;
-	m_Sections.push_back(*pSection);
+	Section.szName = szSection;
+	Section.szComment = szComment;
+	m_SectionIndex.emplace(Section.szName, m_Sections.size());
+	m_Sections.push_back(std::move(Section));
 	m_bDirty = true;
 
 	return true;
@@ -637,15 +769,16 @@ bool CDataFile::CreateSection(t_Str szSection, t_Str szComment, KeyList Keys)
 	pSection->szName = szSection;
 	for (k_pos = Keys.begin(); k_pos != Keys.end(); k_pos++)
 	{
-		t_Key* pKey = new t_Key;
-		pKey->szComment = (*k_pos).szComment;
-		pKey->szKey = (*k_pos).szKey;
-		pKey->szValue = (*k_pos).szValue;
+		t_Key Key;
+		Key.szComment = (*k_pos).szComment;
+		Key.szKey = (*k_pos).szKey;
+		Key.szValue = (*k_pos).szValue;
 
-		pSection->Keys.push_back(*pKey);
+		pSection->Keys.push_back(std::move(Key));
 	}
 
-	m_Sections.push_back(*pSection);
+	// CreateSection above already appended the section; only the keys are new.
+	pSection->RebuildKeyIndex();
 	m_bDirty = true;
 
 	return true;
@@ -678,9 +811,8 @@ int CDataFile::KeyCount()
 // GetKey
 // Given a key and section name, looks up the key and if found, returns a
 // pointer to that key, otherwise returns NULL.
-t_Key*	CDataFile::GetKey(t_Str szKey, t_Str szSection)
+t_Key*	CDataFile::GetKey(const t_Str& szKey, const t_Str& szSection)
 {
-	KeyItor k_pos;
 	t_Section* pSection;
 
 	// Since our default section has a name value of t_Str("") this should
@@ -689,29 +821,42 @@ t_Key*	CDataFile::GetKey(t_Str szKey, t_Str szSection)
 	if ((pSection = GetSection(szSection)) == NULL)
 		return NULL;
 
-	for (k_pos = pSection->Keys.begin(); k_pos != pSection->Keys.end(); k_pos++)
-	{
-		if (CompareNoCase((*k_pos).szKey, szKey) == 0)
-			return (t_Key*)&(*k_pos);
-	}
+	NameIndex::const_iterator k_pos = pSection->KeyIndex.find(szKey);
 
-	return NULL;
+	return (k_pos == pSection->KeyIndex.end()) ? NULL : &pSection->Keys[k_pos->second];
 }
 
 // GetSection
 // Given a section name, locates that section in the list and returns a pointer
 // to it. If the section was not found, returns NULL
-t_Section* CDataFile::GetSection(t_Str szSection)
+t_Section* CDataFile::GetSection(const t_Str& szSection)
 {
-	SectionItor s_pos;
+	NameIndex::const_iterator s_pos = m_SectionIndex.find(szSection);
 
-	for (s_pos = m_Sections.begin(); s_pos != m_Sections.end(); s_pos++)
-	{
-		if (CompareNoCase((*s_pos).szName, szSection) == 0)
-			return (t_Section*)&(*s_pos);
-	}
+	return (s_pos == m_SectionIndex.end()) ? NULL : &m_Sections[s_pos->second];
+}
+
+// RebuildSectionIndex
+// Re-registers every section at its current position, after sections were
+// removed from the middle of the list.
+void CDataFile::RebuildSectionIndex()
+{
+	m_SectionIndex.clear();
+	m_SectionIndex.reserve(m_Sections.size());
 
-	return NULL;
+	for (size_t nPos = 0; nPos < m_Sections.size(); nPos++)
+		m_SectionIndex.emplace(m_Sections[nPos].szName, nPos);
+}
+
+// RebuildKeyIndex
+// Same as RebuildSectionIndex for the keys of one section.
+void st_section::RebuildKeyIndex()
+{
+	KeyIndex.clear();
+	KeyIndex.reserve(Keys.size());
+
+	for (size_t nPos = 0; nPos < Keys.size(); nPos++)
+		KeyIndex.emplace(Keys[nPos].szKey, nPos);
 }
 
 
@@ -769,7 +914,7 @@ t_Str GetNextWord(t_Str& CommandLine)
 // it's amazing what features std::string lacks.  This function simply
 // does a lowercase compare against the two strings, returning 0 if they
 // match.
-int CompareNoCase(t_Str str1, t_Str str2)
+int CompareNoCase(const t_Str& str1, const t_Str& str2)
 {
 #ifdef WIN32
 	return _stricmp(str1.c_str(), str2.c_str());
@@ -778,51 +923,93 @@ int CompareNoCase(t_Str str1, t_Str str2)
 #endif
 }
 
-// Trim
-// Trims whitespace from both sides of a string.
-void Trim(t_Str& szStr)
+// NoCaseHash
+// FNV-1a over the lowercased characters, so names that CompareNoCase treats
+// as equal hash equally.
+size_t NoCaseHash::operator()(std::string_view str) const
+{
+	size_t nHash = static_cast<size_t>(14695981039346656037ull);
+
+	for (unsigned char c : str)
+	{
+		nHash ^= static_cast<size_t>(tolower(c));
+		nHash *= static_cast<size_t>(1099511628211ull);
+	}
+
+	return nHash;
+}
+
+// NoCaseEqual
+// Length-aware lowercase compare, so it also works on views that are not
+// null terminated.
+bool NoCaseEqual::operator()(std::string_view str1, std::string_view str2) const
 {
-	t_Str szTrimChars = WhiteSpace;
+	if (str1.size() != str2.size())
+		return false;
+
+	for (size_t nPos = 0; nPos < str1.size(); nPos++)
+	{
+		if (tolower(static_cast<unsigned char>(str1[nPos])) != tolower(static_cast<unsigned char>(str2[nPos])))
+			return false;
+	}
 
-	szTrimChars += EqualIndicators;
-	int nPos, rPos;
+	return true;
+}
+
+// TrimView
+// Same as Trim, for a view into a buffer that must not be modified.
+std::string_view TrimView(std::string_view szStr)
+{
+	const size_t nFirst = szStr.find_first_not_of(TrimChars);
 
-	// trim left
-	nPos = static_cast<int>(szStr.find_first_not_of(szTrimChars));
+	if (nFirst == std::string_view::npos)
+		return std::string_view();
 
-	if (nPos > 0)
-		szStr.erase(0, nPos);
+	return szStr.substr(nFirst, szStr.find_last_not_of(TrimChars) - nFirst + 1);
+}
 
-	// trim right and return
-	nPos = static_cast<int>(szStr.find_last_not_of(szTrimChars));
-	rPos = static_cast<int>(szStr.find_last_of(szTrimChars));
+// Trim
+// Trims whitespace (and stray '=' / ':' delimiters) from both sides of a string.
+void Trim(t_Str& szStr)
+{
+	std::string_view szTrimmed = TrimView(szStr);
 
-	if (rPos > nPos && rPos > -1)
-		szStr.erase(rPos, szStr.size() - rPos);
+	szStr = t_Str(szTrimmed);
 }
 
 // WriteLn
 // Writes the formatted output to the file stream, returning the number of
-// bytes written.
+// bytes written. Lines longer than MAX_BUFFER_LEN are formatted into a heap
+// buffer instead of being cut off.
 int WriteLn(std::fstream& stream, const char* fmt, ...)
 {
 	char buf[MAX_BUFFER_LEN];
 	int nLength;
-	t_Str szMsg;
+	t_Str szLong;
+	char* pLine = buf;
 
-	memset(buf, 0, MAX_BUFFER_LEN);
 	va_list args;
 
 	va_start(args, fmt);
-	nLength = _vsnprintf_s(buf, MAX_BUFFER_LEN, fmt, args);
+	nLength = vsnprintf(NULL, 0, fmt, args);
 	va_end(args);
 
+	if (nLength < 0)
+		return 0;
 
-	if (buf[nLength] != '\n' && buf[nLength] != '\r')
-		buf[nLength++] = '\n';
+	if (nLength + 2 > MAX_BUFFER_LEN)
+	{
+		szLong.resize(static_cast<size_t>(nLength) + 2);
+		pLine = &szLong[0];
+	}
+
+	va_start(args, fmt);
+	vsnprintf(pLine, static_cast<size_t>(nLength) + 1, fmt, args);
+	va_end(args);
 
+	pLine[nLength++] = '\n';
 
-	stream.write(buf, nLength);
+	stream.write(pLine, nLength);
 
 	return nLength;
 }
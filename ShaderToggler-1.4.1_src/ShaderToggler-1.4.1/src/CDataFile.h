@@ -13,12 +13,16 @@
 //
 #pragma once
 
+#ifdef _WIN32
 #include "stdafx.h"
+#endif
 #include <vector>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <filesystem>
+#include <unordered_map>
 
 using namespace std;
 
@@ -45,6 +49,25 @@ const t_Str CommentIndicators = t_Str(";#");
 const t_Str EqualIndicators   = t_Str("=:");
 const t_Str WhiteSpace        = t_Str(" \t\n\r");
 
+int     CompareNoCase(const t_Str& str1, const t_Str& str2);
+
+// Case-insensitive hash and equality matching CompareNoCase, for the section and key indexes.
+// Both are transparent so Load can look names up straight from the file buffer.
+struct NoCaseHash
+{
+	typedef void is_transparent;
+	size_t operator()(std::string_view str) const;
+};
+
+struct NoCaseEqual
+{
+	typedef void is_transparent;
+	bool operator()(std::string_view str1, std::string_view str2) const;
+};
+
+// Name -> position in the owning list. The lists keep file order; the index only speeds up lookups.
+typedef std::unordered_map<t_Str, size_t, NoCaseHash, NoCaseEqual> NameIndex;
+
 typedef struct st_key
 {
 	t_Str szKey;
@@ -68,6 +91,7 @@ typedef struct st_section
 	t_Str szName;
 	t_Str szComment;
 	KeyList Keys;
+	NameIndex KeyIndex;
 
 	st_section()
 	{
@@ -76,6 +100,8 @@ typedef struct st_section
 		Keys.clear();
 	}
 
+	void RebuildKeyIndex();
+
 } t_Section;
 
 typedef std::vector<t_Section> SectionList;
@@ -83,8 +109,8 @@ typedef SectionList::iterator SectionItor;
 
 void    Report(e_DebugLevel DebugLevel, const char *fmt, ...);
 t_Str   GetNextWord(t_Str& CommandLine);
-int     CompareNoCase(t_Str str1, t_Str str2);
 void    Trim(t_Str& szStr);
+std::string_view TrimView(std::string_view szStr);
 int     WriteLn(fstream& stream, const char* fmt, ...);
 
 class CDataFile
@@ -135,6 +161,8 @@ public:
 	int  KeyCount();
 	void Clear();
 	void SetFileName(const std::filesystem::path& fileName);
+	void SetHeader(const t_Str& szHeader);
+	void SetFooter(const t_Str& szFooter);
 	t_Str CommentStr(t_Str szComment);
 
 	// -----------------------------------------------------------------
@@ -145,17 +173,24 @@ public:
 		t_Str szComment = t_Str(""), t_Str szSection = t_Str(""));
 	bool SetString(t_Str szKey, t_Str szValue,
 		t_Str szComment = t_Str(""), t_Str szSection = t_Str(""));
+	// The keys of a section in file order, or NULL if there is no such section.
+	const KeyList* GetSectionKeys(const t_Str& szSection);
 
 protected:
-	t_Key* GetKey(t_Str szKey, t_Str szSection);
-	t_Section* GetSection(t_Str szSection);
+	t_Key* GetKey(const t_Str& szKey, const t_Str& szSection);
+	t_Section* GetSection(const t_Str& szSection);
+	void RebuildSectionIndex();
+	void ParseBuffer(std::string_view szData);
 
 public:
 	long m_Flags;
 
 protected:
 	SectionList m_Sections;
+	NameIndex m_SectionIndex;
 	std::filesystem::path m_szFileName;
+	t_Str m_szHeader;
+	t_Str m_szFooter;
 	bool m_bDirty;
 };
 //GT
\ No newline at end of file
@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <fstream>
+#include "ConfigCache.h"
+
+namespace ShaderToggler
+{
+	static const uint32_t CONFIG_CACHE_MAGIC = 0x48435453;		// "STCH"
+	static const uint32_t CONFIG_CACHE_VERSION = 1;
+
+	struct ConfigCacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t iniSize;
+		int64_t iniWriteTime;
+		uint32_t payloadSize;
+		uint32_t payloadChecksum;
+	};
+
+	static uint32_t fnv1a32(const uint8_t* data, size_t length)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash ^= data[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	static bool getIniStamp(const std::filesystem::path& iniFileName, uint64_t& size, int64_t& writeTime)
+	{
+		std::error_code error;
+		const auto lastWrite = std::filesystem::last_write_time(iniFileName, error);
+		if (error)
+		{
+			return false;
+		}
+
+		size = std::filesystem::file_size(iniFileName, error);
+		writeTime = static_cast<int64_t>(lastWrite.time_since_epoch().count());
+		return !error;
+	}
+
+
+	void ConfigCacheWriter::writeUInt(uint32_t value)
+	{
+		const size_t offset = _buffer.size();
+		_buffer.resize(offset + sizeof(value));
+		memcpy(_buffer.data() + offset, &value, sizeof(value));
+	}
+
+
+	void ConfigCacheWriter::writeInt(int32_t value)
+	{
+		writeUInt(static_cast<uint32_t>(value));
+	}
+
+
+	void ConfigCacheWriter::writeString(const std::string& value)
+	{
+		writeUInt(static_cast<uint32_t>(value.size()));
+		const size_t offset = _buffer.size();
+		// padded so the next field stays aligned.
+		_buffer.resize(offset + ((value.size() + 3) & ~static_cast<size_t>(3)), 0);
+		memcpy(_buffer.data() + offset, value.data(), value.size());
+	}
+
+
+	void ConfigCacheWriter::writeUIntArray(const std::vector<uint32_t>& values)
+	{
+		writeUInt(static_cast<uint32_t>(values.size()));
+		const size_t offset = _buffer.size();
+		_buffer.resize(offset + values.size() * sizeof(uint32_t));
+		if (!values.empty())
+		{
+			memcpy(_buffer.data() + offset, values.data(), values.size() * sizeof(uint32_t));
+		}
+	}
+
+
+	ConfigCacheReader::ConfigCacheReader(const uint8_t* data, size_t size)
+		: _data(data)
+		, _size(size)
+	{
+	}
+
+
+	const uint8_t* ConfigCacheReader::take(size_t length)
+	{
+		if (_failed || length > _size - _position)
+		{
+			_failed = true;
+			return nullptr;
+		}
+
+		const uint8_t* field = _data + _position;
+		_position += length;
+		return field;
+	}
+
+
+	uint32_t ConfigCacheReader::readUInt()
+	{
+		const uint8_t* field = take(sizeof(uint32_t));
+		uint32_t value = 0;
+		if (field != nullptr)
+		{
+			memcpy(&value, field, sizeof(value));
+		}
+		return value;
+	}
+
+
+	int32_t ConfigCacheReader::readInt()
+	{
+		return static_cast<int32_t>(readUInt());
+	}
+
+
+	std::string ConfigCacheReader::readString()
+	{
+		const uint32_t length = readUInt();
+		const uint8_t* field = take((static_cast<size_t>(length) + 3) & ~static_cast<size_t>(3));
+		if (field == nullptr)
+		{
+			return std::string();
+		}
+		return std::string(reinterpret_cast<const char*>(field), length);
+	}
+
+
+	uint32_t ConfigCacheReader::readUIntArray(const uint32_t*& values)
+	{
+		const uint32_t count = readUInt();
+		const uint8_t* field = take(static_cast<size_t>(count) * sizeof(uint32_t));
+		values = reinterpret_cast<const uint32_t*>(field);
+		return field == nullptr ? 0 : count;
+	}
+
+
+	std::filesystem::path ConfigCache::getCachePath(const std::filesystem::path& iniFileName)
+	{
+		std::filesystem::path cachePath = iniFileName;
+		cachePath.replace_extension(".stcache");
+		return cachePath;
+	}
+
+
+	bool ConfigCache::write(const std::filesystem::path& iniFileName, const std::vector<uint8_t>& payload)
+	{
+		ConfigCacheHeader header = {};
+		header.magic = CONFIG_CACHE_MAGIC;
+		header.version = CONFIG_CACHE_VERSION;
+		header.payloadSize = static_cast<uint32_t>(payload.size());
+		header.payloadChecksum = fnv1a32(payload.data(), payload.size());
+		if (!getIniStamp(iniFileName, header.iniSize, header.iniWriteTime))
+		{
+			return false;
+		}
+
+		// same temp-and-rename as CDataFile::Save, a torn cache must never look valid.
+		const std::filesystem::path cachePath = getCachePath(iniFileName);
+		std::filesystem::path tempPath = cachePath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream file(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+			if (!file.good())
+			{
+				file.close();
+				std::error_code ignored;
+				std::filesystem::remove(tempPath, ignored);
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+		if (error)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(tempPath, ignored);
+			return false;
+		}
+		return true;
+	}
+
+
+	bool ConfigCache::read(const std::filesystem::path& iniFileName, std::vector<uint8_t>& payload)
+	{
+		uint64_t iniSize = 0;
+		int64_t iniWriteTime = 0;
+		if (!getIniStamp(iniFileName, iniSize, iniWriteTime))
+		{
+			return false;
+		}
+
+		std::ifstream file(getCachePath(iniFileName), std::ios::in | std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		ConfigCacheHeader header = {};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file.good() ||
+			header.magic != CONFIG_CACHE_MAGIC ||
+			header.version != CONFIG_CACHE_VERSION ||
+			header.iniSize != iniSize ||
+			header.iniWriteTime != iniWriteTime)
+		{
+			return false;
+		}
+
+		payload.resize(header.payloadSize);
+		file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+		if (file.gcount() != static_cast<std::streamsize>(payload.size()) ||
+			fnv1a32(payload.data(), payload.size()) != header.payloadChecksum)
+		{
+			payload.clear();
+			return false;
+		}
+		return true;
+	}
+
+
+	void ConfigCache::remove(const std::filesystem::path& iniFileName)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(getCachePath(iniFileName), ignored);
+	}
+}
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ShaderToggler
+{
+	// Appends fields to the payload of the binary config cache. Values are stored little endian and every field
+	// starts 4-byte aligned, so a reader can use the uint32 arrays straight from the loaded buffer.
+	class ConfigCacheWriter
+	{
+	public:
+		void writeUInt(uint32_t value);
+		void writeInt(int32_t value);
+		void writeString(const std::string& value);
+		void writeUIntArray(const std::vector<uint32_t>& values);
+
+		std::vector<uint8_t>& getBuffer() { return _buffer; }
+
+	private:
+		std::vector<uint8_t> _buffer;
+	};
+
+	// Reads fields in the order ConfigCacheWriter wrote them. Reading past the end returns zeros and marks the
+	// reader as failed, so callers check failed() once at the end.
+	class ConfigCacheReader
+	{
+	public:
+		ConfigCacheReader(const uint8_t* data, size_t size);
+
+		uint32_t readUInt();
+		int32_t readInt();
+		std::string readString();
+		// Returns the number of values; values points into the buffer.
+		uint32_t readUIntArray(const uint32_t*& values);
+
+		bool failed() const { return _failed; }
+		bool atEnd() const { return _position == _size; }
+
+	private:
+		const uint8_t* take(size_t length);
+
+		const uint8_t* _data;
+		size_t _size;
+		size_t _position = 0;
+		bool _failed = false;
+	};
+
+	// Binary sidecar of the INI (same name, extension .stcache). It is written right after the INI and records
+	// the INI's size and write time; read() only returns the payload while the INI on disk still matches them.
+	class ConfigCache
+	{
+	public:
+		static std::filesystem::path getCachePath(const std::filesystem::path& iniFileName);
+		static bool write(const std::filesystem::path& iniFileName, const std::vector<uint8_t>& payload);
+		static bool read(const std::filesystem::path& iniFileName, std::vector<uint8_t>& payload);
+		static void remove(const std::filesystem::path& iniFileName);
+	};
+}
@@ -0,0 +1,278 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "CDataFile.h"
+#include "ConfigPersistenceWorker.h"
+
+namespace ShaderToggler
+{
+	ConfigPersistenceWorker::~ConfigPersistenceWorker()
+	{
+		// destroyed when the module unloads, under the loader lock.
+		abandon();
+	}
+
+
+	void ConfigPersistenceWorker::start(uint32_t debounceMs, uint32_t maxDelayMs)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_thread.joinable())
+		{
+			return;
+		}
+
+		_debounce = std::chrono::milliseconds(debounceMs);
+		_maxDelay = std::chrono::milliseconds(std::max(maxDelayMs, debounceMs));
+		_stopRequested = false;
+		_running = true;
+		_thread = std::thread(&ConfigPersistenceWorker::run, this);
+	}
+
+
+	void ConfigPersistenceWorker::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_running = false;
+			if (!_thread.joinable())
+			{
+				return;
+			}
+			_stopRequested = true;
+		}
+		_wakeup.notify_all();
+		_thread.join();
+
+		// a snapshot submitted while the thread was shutting down.
+		flush();
+	}
+
+
+	void ConfigPersistenceWorker::abandon()
+	{
+		std::unique_ptr<CDataFile> snapshot;
+		WrittenCallback onWritten;
+		Clock::time_point firstSubmitted;
+		{
+			// a thread ended by ExitProcess may have died holding the lock; the snapshot is lost then.
+			std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+			if (lock.owns_lock())
+			{
+				_running = false;
+				_stopRequested = true;
+				snapshot = std::move(_pendingSnapshot);
+				onWritten = std::move(_pendingOnWritten);
+				firstSubmitted = _firstSubmitted;
+			}
+		}
+		_wakeup.notify_all();
+
+		if (_thread.joinable())
+		{
+			_thread.detach();
+		}
+
+		if (snapshot)
+		{
+			std::unique_lock<std::mutex> writeLock(_writeMutex, std::try_to_lock);
+			if (writeLock.owns_lock())
+			{
+				writeSnapshotLocked(*snapshot, onWritten, firstSubmitted);
+			}
+			snapshot->Clear();
+		}
+	}
+
+
+	bool ConfigPersistenceWorker::isRunning() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _running;
+	}
+
+
+	void ConfigPersistenceWorker::submit(std::unique_ptr<CDataFile> snapshot, WrittenCallback onWritten)
+	{
+		if (!snapshot)
+		{
+			return;
+		}
+
+		const Clock::time_point now = Clock::now();
+		std::unique_ptr<CDataFile> superseded;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_stats.snapshotsSubmitted;
+
+			if (!_running)
+			{
+				superseded = std::move(_pendingSnapshot);
+				_pendingSnapshot = std::move(snapshot);
+				_pendingOnWritten = std::move(onWritten);
+				_firstSubmitted = now;
+			}
+			else
+			{
+				if (_pendingSnapshot)
+				{
+					superseded = std::move(_pendingSnapshot);
+					++_stats.snapshotsCoalesced;
+				}
+				else
+				{
+					_firstSubmitted = now;
+				}
+				_pendingSnapshot = std::move(snapshot);
+				_pendingOnWritten = std::move(onWritten);
+				_lastSubmitted = now;
+			}
+		}
+
+		// the superseded model is still dirty; clearing it keeps its destructor from saving it.
+		if (superseded)
+		{
+			superseded->Clear();
+		}
+
+		if (!isRunning())
+		{
+			flush();
+			return;
+		}
+		_wakeup.notify_all();
+	}
+
+
+	void ConfigPersistenceWorker::flush()
+	{
+		std::unique_ptr<CDataFile> snapshot;
+		WrittenCallback onWritten;
+		Clock::time_point firstSubmitted;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			snapshot = std::move(_pendingSnapshot);
+			onWritten = std::move(_pendingOnWritten);
+			firstSubmitted = _firstSubmitted;
+		}
+
+		if (snapshot)
+		{
+			writeSnapshot(std::move(snapshot), std::move(onWritten), firstSubmitted);
+		}
+	}
+
+
+	bool ConfigPersistenceWorker::hasPendingSnapshot() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _pendingSnapshot != nullptr;
+	}
+
+
+	ConfigPersistenceWorker::Stats ConfigPersistenceWorker::getStats() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+
+	void ConfigPersistenceWorker::writeSnapshot(std::unique_ptr<CDataFile> snapshot, WrittenCallback onWritten, Clock::time_point firstSubmitted)
+	{
+		std::lock_guard<std::mutex> writeLock(_writeMutex);
+		writeSnapshotLocked(*snapshot, onWritten, firstSubmitted);
+		snapshot->Clear();
+	}
+
+
+	void ConfigPersistenceWorker::writeSnapshotLocked(CDataFile& snapshot, const WrittenCallback& onWritten, Clock::time_point firstSubmitted)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_stats.writesStarted;
+		}
+
+		const Clock::time_point writeStart = Clock::now();
+		const bool saved = snapshot.Save();
+		const Clock::time_point writeEnd = Clock::now();
+
+		// under the write lock, so follow-up files are written in the same order as the snapshots.
+		if (onWritten)
+		{
+			onWritten(snapshot, saved);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_stats.writes;
+		if (!saved)
+		{
+			++_stats.failedWrites;
+		}
+		_stats.lastQueueLatencyMs = std::chrono::duration<float, std::milli>(writeStart - firstSubmitted).count();
+		_stats.lastWriteMs = std::chrono::duration<float, std::milli>(writeEnd - writeStart).count();
+		_stats.maxWriteMs = std::max(_stats.maxWriteMs, _stats.lastWriteMs);
+	}
+
+
+	void ConfigPersistenceWorker::run()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (!_stopRequested)
+		{
+			if (!_pendingSnapshot)
+			{
+				_wakeup.wait(lock, [this] { return _stopRequested || _pendingSnapshot != nullptr; });
+				continue;
+			}
+
+			const Clock::time_point writeAt = std::min(_lastSubmitted + _debounce, _firstSubmitted + _maxDelay);
+			if (Clock::now() < writeAt)
+			{
+				// woken early by a newer snapshot or stop; both re-evaluate the deadline above.
+				_wakeup.wait_until(lock, writeAt);
+				continue;
+			}
+
+			std::unique_ptr<CDataFile> snapshot = std::move(_pendingSnapshot);
+			WrittenCallback onWritten = std::move(_pendingOnWritten);
+			const Clock::time_point firstSubmitted = _firstSubmitted;
+			lock.unlock();
+			writeSnapshot(std::move(snapshot), std::move(onWritten), firstSubmitted);
+			lock.lock();
+		}
+	}
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class CDataFile;
+
+namespace ShaderToggler
+{
+	// Writes config snapshots on its own thread. A snapshot is a fully built CDataFile with its file name set;
+	// the worker owns it from submit() on. Snapshots submitted in quick succession are coalesced: only the newest
+	// is written, once no new one arrived for the debounce window or the oldest waited for the maximum delay.
+	class ConfigPersistenceWorker
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		using WrittenCallback = std::function<void(CDataFile& snapshot, bool saved)>;
+
+		struct Stats
+		{
+			uint32_t snapshotsSubmitted = 0;
+			uint32_t snapshotsCoalesced = 0;
+			uint32_t writesStarted = 0;							// counted before the file is touched
+			uint32_t writes = 0;								// counted once the file is in place
+			uint32_t failedWrites = 0;
+			float lastQueueLatencyMs = 0.0f;		// first submit of the written burst -> write start
+			float lastWriteMs = 0.0f;
+			float maxWriteMs = 0.0f;
+		};
+
+		ConfigPersistenceWorker() = default;
+		~ConfigPersistenceWorker();
+
+		ConfigPersistenceWorker(const ConfigPersistenceWorker&) = delete;
+		ConfigPersistenceWorker& operator=(const ConfigPersistenceWorker&) = delete;
+
+		void start(uint32_t debounceMs, uint32_t maxDelayMs);
+		// Writes a pending snapshot before the thread ends.
+		void stop();
+		// For DLL_PROCESS_DETACH and static destruction, where joining could deadlock on the loader lock: asks the
+		// thread to end without waiting for it, and writes a pending snapshot only if no write is in progress. The
+		// thread must already be gone or stopped, as on ExitProcess; otherwise call stop().
+		void abandon();
+		bool isRunning() const;
+
+		// Without a running thread the snapshot is written right away on the calling thread. onWritten runs after
+		// the write on the writing thread, with the written snapshot and the result of the save; it is dropped
+		// with a superseded snapshot.
+		void submit(std::unique_ptr<CDataFile> snapshot, WrittenCallback onWritten = nullptr);
+		// Writes a pending snapshot now, on the calling thread.
+		void flush();
+		bool hasPendingSnapshot() const;
+
+		Stats getStats() const;
+
+	private:
+		void run();
+		void writeSnapshot(std::unique_ptr<CDataFile> snapshot, WrittenCallback onWritten, Clock::time_point firstSubmitted);
+		// The caller holds _writeMutex.
+		void writeSnapshotLocked(CDataFile& snapshot, const WrittenCallback& onWritten, Clock::time_point firstSubmitted);
+
+		std::thread _thread;
+		mutable std::mutex _mutex;
+		std::condition_variable _wakeup;
+		std::mutex _writeMutex;										// one writer at a time, worker or flush()
+		// guarded by _mutex
+		std::unique_ptr<CDataFile> _pendingSnapshot;
+		WrittenCallback _pendingOnWritten;
+		Clock::time_point _firstSubmitted;
+		Clock::time_point _lastSubmitted;
+		bool _stopRequested = false;
+		bool _running = false;
+		std::chrono::milliseconds _debounce{ 500 };
+		std::chrono::milliseconds _maxDelay{ 3000 };
+		Stats _stats;
+	};
+}
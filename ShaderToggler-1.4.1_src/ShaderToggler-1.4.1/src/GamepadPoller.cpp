@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include "GamepadPoller.h"
+
+namespace ShaderToggler
+{
+	GamepadPoller::~GamepadPoller()
+	{
+		// the add-on's poller is destroyed when the module unloads, under the loader lock.
+		abandon();
+	}
+
+
+	void GamepadPoller::start(GamepadPollingBackend& backend, uint32_t pollIntervalMs, uint32_t detectIntervalMs)
+	{
+		if (_thread.joinable())
+		{
+			return;
+		}
+
+		setPollIntervalMs(pollIntervalMs);
+		_detectIntervalMs = std::max<uint32_t>(detectIntervalMs, 1);
+		{
+			std::lock_guard<std::mutex> lock(_wakeupMutex);
+			_stopRequested = false;
+		}
+
+		// publish a first state before readers switch over to the poller.
+		detectOnce(backend);
+		pollOnce(backend);
+		_pressedCodes.store(0, std::memory_order_release);
+
+		_thread = std::thread(&GamepadPoller::run, this, &backend);
+		_running.store(true, std::memory_order_release);
+	}
+
+
+	void GamepadPoller::stop()
+	{
+		_running.store(false, std::memory_order_release);
+		if (!_thread.joinable())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_wakeupMutex);
+			_stopRequested = true;
+		}
+		_wakeup.notify_all();
+		_thread.join();
+	}
+
+
+	void GamepadPoller::abandon()
+	{
+		_running.store(false, std::memory_order_release);
+		if (!_thread.joinable())
+		{
+			return;
+		}
+
+		// without the mutex, which a thread ended by ExitProcess may have died holding; a live thread sees the
+		// flag at its next wakeup at the latest.
+		_stopRequested = true;
+		_wakeup.notify_all();
+		_thread.detach();
+	}
+
+
+	void GamepadPoller::setPollIntervalMs(uint32_t pollIntervalMs)
+	{
+		_pollIntervalMs.store(std::max<uint32_t>(pollIntervalMs, 1), std::memory_order_relaxed);
+	}
+
+
+	void GamepadPoller::readDownCodes(GamepadCodeMask& previous, GamepadCodeMask& current) const
+	{
+		const uint32_t packed = _downCodes.load(std::memory_order_acquire);
+		previous = static_cast<GamepadCodeMask>(packed >> 16);
+		current = static_cast<GamepadCodeMask>(packed & 0xFFFF);
+	}
+
+
+	void GamepadPoller::pollOnce(GamepadPollingBackend& backend)
+	{
+		GamepadCodeMask current = 0;
+		if (!backend.pollDownCodes(current))
+		{
+			current = 0;
+		}
+
+		// only this thread writes _downCodes, so the previous poll can be read back relaxed.
+		const GamepadCodeMask previous = static_cast<GamepadCodeMask>(_downCodes.load(std::memory_order_relaxed) & 0xFFFF);
+		_downCodes.store((static_cast<uint32_t>(previous) << 16) | current, std::memory_order_release);
+
+		const GamepadCodeMask pressed = current & ~previous;
+		if (pressed != 0)
+		{
+			_pressedCodes.fetch_or(pressed, std::memory_order_acq_rel);
+		}
+	}
+
+
+	void GamepadPoller::detectOnce(GamepadPollingBackend& backend)
+	{
+		_playStationDetected.store(backend.detectPlayStationController(), std::memory_order_release);
+	}
+
+
+	void GamepadPoller::run(GamepadPollingBackend* backend)
+	{
+		auto lastDetect = std::chrono::steady_clock::now();
+
+		std::unique_lock<std::mutex> lock(_wakeupMutex);
+		while (!_wakeup.wait_for(lock, std::chrono::milliseconds(_pollIntervalMs.load(std::memory_order_relaxed)), [this] { return _stopRequested.load(); }))
+		{
+			lock.unlock();
+
+			pollOnce(*backend);
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now - lastDetect >= std::chrono::milliseconds(_detectIntervalMs))
+			{
+				detectOnce(*backend);
+				lastDetect = now;
+			}
+
+			lock.lock();
+		}
+	}
+}
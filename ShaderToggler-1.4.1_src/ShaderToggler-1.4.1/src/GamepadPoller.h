@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace ShaderToggler
+{
+	// Gamepad codes (see KeyData, 240-255) as bits 0-15.
+	using GamepadCodeMask = uint16_t;
+
+	// Source of the gamepad state, XInput in the add-on. Implementations are called from the polling thread only.
+	class GamepadPollingBackend
+	{
+	public:
+		virtual ~GamepadPollingBackend() = default;
+
+		// Returns false, with downCodes cleared, if no controller is connected.
+		virtual bool pollDownCodes(GamepadCodeMask& downCodes) = 0;
+		virtual bool detectPlayStationController() = 0;
+	};
+
+	// Polls a GamepadPollingBackend on its own thread and publishes the result through atomics, so the present
+	// thread never calls into the driver. Presses are accumulated until taken, so a button pressed and released
+	// between two frames still triggers.
+	class GamepadPoller
+	{
+	public:
+		GamepadPoller() = default;
+		~GamepadPoller();
+
+		GamepadPoller(const GamepadPoller&) = delete;
+		GamepadPoller& operator=(const GamepadPoller&) = delete;
+
+		void start(GamepadPollingBackend& backend, uint32_t pollIntervalMs, uint32_t detectIntervalMs);
+		void stop();
+		// Asks the thread to end and detaches it without waiting, for DLL_PROCESS_DETACH and static destruction
+		// where a join could deadlock on the loader lock. The thread must already be gone, as on ExitProcess, or
+		// not touch the poller anymore; otherwise call stop().
+		void abandon();
+		bool isRunning() const { return _running.load(std::memory_order_acquire); }
+		void setPollIntervalMs(uint32_t pollIntervalMs);
+
+		// Previous and current poll, read as one consistent pair.
+		void readDownCodes(GamepadCodeMask& previous, GamepadCodeMask& current) const;
+		// Codes that went down since the last call.
+		GamepadCodeMask takePressedCodes() { return static_cast<GamepadCodeMask>(_pressedCodes.exchange(0, std::memory_order_acq_rel)); }
+		bool isPlayStationControllerDetected() const { return _playStationDetected.load(std::memory_order_acquire); }
+
+		// One iteration of the polling thread. Public so the poller can be driven without a thread.
+		void pollOnce(GamepadPollingBackend& backend);
+		void detectOnce(GamepadPollingBackend& backend);
+
+	private:
+		void run(GamepadPollingBackend* backend);
+
+		std::thread _thread;
+		std::mutex _wakeupMutex;
+		std::condition_variable _wakeup;
+		std::atomic_bool _stopRequested = false;					// set under _wakeupMutex, except by abandon()
+		std::atomic_bool _running = false;
+		std::atomic_uint32_t _pollIntervalMs = 4;
+		uint32_t _detectIntervalMs = 3000;
+		std::atomic_uint32_t _downCodes = 0;						// previous poll << 16 | current poll
+		std::atomic_uint32_t _pressedCodes = 0;
+		std::atomic_bool _playStationDetected = false;
+	};
+}
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "GroupDeadlineScheduler.h"
+
+namespace ShaderToggler
+{
+	namespace
+	{
+		template <typename TEntry>
+		bool isLaterDeadline(const TEntry& a, const TEntry& b)
+		{
+			return a.deadline > b.deadline;
+		}
+	}
+
+
+	GroupDeadlineScheduler::GroupDeadlineScheduler(NowFunction nowFunction) : _nowFunction(nowFunction != nullptr ? nowFunction : &Clock::now)
+	{
+	}
+
+
+	void GroupDeadlineScheduler::reset(size_t slotCount)
+	{
+		_heap.clear();
+		_deadlineBySlot.assign(slotCount, TimePoint::max());
+		_pendingCount = 0;
+		// compactIfMostlyStale() keeps the heap within this size.
+		_heap.reserve(std::max<size_t>(slotCount * 4, 64));
+	}
+
+
+	void GroupDeadlineScheduler::schedule(uint32_t slot, TimePoint deadline)
+	{
+		if (slot >= _deadlineBySlot.size() || deadline == TimePoint::max())
+		{
+			cancel(slot);
+			return;
+		}
+
+		TimePoint& current = _deadlineBySlot[slot];
+		if (current == deadline)
+		{
+			return;
+		}
+
+		if (current == TimePoint::max())
+		{
+			++_pendingCount;
+		}
+		current = deadline;
+
+		compactIfMostlyStale();
+		_heap.push_back({ deadline, slot });
+		std::push_heap(_heap.begin(), _heap.end(), isLaterDeadline<Entry>);
+	}
+
+
+	void GroupDeadlineScheduler::cancel(uint32_t slot)
+	{
+		// the heap entry stays and is dropped once it surfaces.
+		if (slot < _deadlineBySlot.size() && _deadlineBySlot[slot] != TimePoint::max())
+		{
+			_deadlineBySlot[slot] = TimePoint::max();
+			--_pendingCount;
+		}
+	}
+
+
+	GroupDeadlineScheduler::Entry GroupDeadlineScheduler::popTop()
+	{
+		std::pop_heap(_heap.begin(), _heap.end(), isLaterDeadline<Entry>);
+		const Entry top = _heap.back();
+		_heap.pop_back();
+		return top;
+	}
+
+
+	void GroupDeadlineScheduler::compactIfMostlyStale()
+	{
+		// Rescheduling every frame (e.g. while a trigger key is held) leaves one stale entry per frame behind.
+		// Rebuild from the live deadlines before that would make the heap grow past its reserved size.
+		if (_heap.size() < 64 || _heap.size() < _pendingCount * 4)
+		{
+			return;
+		}
+
+		_heap.clear();
+		for (uint32_t slot = 0; slot < _deadlineBySlot.size(); ++slot)
+		{
+			if (_deadlineBySlot[slot] != TimePoint::max())
+			{
+				_heap.push_back({ _deadlineBySlot[slot], slot });
+			}
+		}
+		std::make_heap(_heap.begin(), _heap.end(), isLaterDeadline<Entry>);
+	}
+}
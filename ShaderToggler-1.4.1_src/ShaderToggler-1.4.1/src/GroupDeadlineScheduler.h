@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ShaderToggler
+{
+	// Min-heap of per-slot deadlines, used by the present loop to only revisit toggle groups whose timers
+	// (startup, suppression linger, auto-hide, fade-out) have actually expired. A slot has at most one live
+	// deadline; rescheduling leaves the old heap entry behind, which is skipped when it reaches the top.
+	// The clock is injectable so the scheduling can be driven deterministically.
+	// Not thread safe, only used from the present thread.
+	class GroupDeadlineScheduler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		using TimePoint = Clock::time_point;
+		using NowFunction = TimePoint(*)();
+
+		explicit GroupDeadlineScheduler(NowFunction nowFunction = &Clock::now);
+
+		TimePoint now() const { return _nowFunction(); }
+		void setNowFunction(NowFunction nowFunction) { _nowFunction = nowFunction; }
+
+		void reset(size_t slotCount);
+		void schedule(uint32_t slot, TimePoint deadline);
+		void cancel(uint32_t slot);
+		bool isScheduled(uint32_t slot) const { return slot < _deadlineBySlot.size() && _deadlineBySlot[slot] != TimePoint::max(); }
+		size_t getPendingCount() const { return _pendingCount; }
+
+		// Calls onExpired(slot) for every slot whose deadline is at or before 'now', in deadline order,
+		// and unschedules it.
+		template <typename Callback>
+		void popExpired(TimePoint now, Callback&& onExpired)
+		{
+			while (!_heap.empty() && _heap.front().deadline <= now)
+			{
+				const Entry top = popTop();
+				if (top.slot < _deadlineBySlot.size() && _deadlineBySlot[top.slot] == top.deadline)
+				{
+					_deadlineBySlot[top.slot] = TimePoint::max();
+					--_pendingCount;
+					onExpired(top.slot);
+				}
+			}
+		}
+
+	private:
+		struct Entry
+		{
+			TimePoint deadline;
+			uint32_t slot;
+		};
+
+		Entry popTop();
+		void compactIfMostlyStale();
+
+		NowFunction _nowFunction;
+		std::vector<Entry> _heap;
+		std::vector<TimePoint> _deadlineBySlot;		// TimePoint::max() if the slot has no deadline
+		size_t _pendingCount = 0;
+	};
+}
@@ -0,0 +1,388 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "HashPackMerge.h"
+#include "CDataFile.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ShaderToggler
+{
+	// ToggleGroup::PackedHashFormat; ToggleGroup.h needs the Windows headers, so it isn't included here.
+	static constexpr int PackedHashFormat = 2;
+
+	static int hexDigitValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		return -1;
+	}
+
+	// An upper bound for the number of values in a packed list, to reserve for.
+	static size_t countPackedValues(std::string_view packed)
+	{
+		return static_cast<size_t>(std::count(packed.begin(), packed.end(), ',')) + 1;
+	}
+
+	// Single pass; anything but hex digits and commas is skipped, as are values longer than 8 digits.
+	template<typename Sink>
+	static void forEachPackedHash(std::string_view packed, Sink&& sink)
+	{
+		uint32_t value = 0;
+		int digits = 0;
+		for (const char c : packed)
+		{
+			const int nibble = hexDigitValue(c);
+			if (nibble >= 0)
+			{
+				value = (value << 4) | static_cast<uint32_t>(nibble);
+				++digits;
+			}
+			else if (c == ',')
+			{
+				if (digits > 0 && digits <= 8)
+					sink(value);
+				value = 0;
+				digits = 0;
+			}
+		}
+
+		if (digits > 0 && digits <= 8)
+			sink(value);
+	}
+
+	static int getGroupCount(CDataFile& iniFile, bool& usingCustomFormat)
+	{
+		int numberOfGroups = iniFile.GetInt("GTAmountGroups", "General");
+		usingCustomFormat = true;
+
+		if (numberOfGroups == INT_MIN)
+		{
+			numberOfGroups = iniFile.GetInt("AmountGroups", "General");
+			usingCustomFormat = false;
+		}
+
+		return numberOfGroups;
+	}
+
+	static void readHashSection(CDataFile& iniFile, const std::string& section, std::vector<uint32_t>& hashes)
+	{
+		const int amount = iniFile.GetInt("AmountHashes", section);
+		for (int i = 0; i < amount; i++)
+		{
+			const uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), section);
+			if (hash != UINT_MAX)
+				hashes.push_back(hash);
+		}
+	}
+
+	// Sorts a list as read from the file and drops repeated hashes; returns how many were dropped.
+	static uint32_t normalizeHashList(std::vector<uint32_t>& hashes)
+	{
+		std::sort(hashes.begin(), hashes.end());
+		const size_t sizeBefore = hashes.size();
+		hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+		return static_cast<uint32_t>(sizeBefore - hashes.size());
+	}
+
+	static uint32_t normalizeGroup(HashPackGroup& group)
+	{
+		return normalizeHashList(group.pixelShaderHashes)
+			+ normalizeHashList(group.vertexShaderHashes)
+			+ normalizeHashList(group.computeShaderHashes);
+	}
+
+	static size_t countHashes(const HashPackGroup& group)
+	{
+		return group.pixelShaderHashes.size() + group.vertexShaderHashes.size() + group.computeShaderHashes.size();
+	}
+
+	static std::string toLowerName(const std::string& name)
+	{
+		std::string lowered(name);
+		std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return lowered;
+	}
+
+	// Merges one stage of a matched group. scratch is reused across calls to keep the allocations down.
+	static bool mergeHashList(std::vector<uint32_t>& target, const std::vector<uint32_t>& source, HashPackMergeMode mode,
+		std::vector<uint32_t>& scratch, HashPackMergeReport& report)
+	{
+		scratch.clear();
+
+		// shared: hashes in both lists. kept: hashes of the target that are still in the result.
+		size_t shared = 0;
+		size_t kept = 0;
+		switch (mode)
+		{
+		case HashPackMergeMode::Union:
+			std::set_union(target.begin(), target.end(), source.begin(), source.end(), std::back_inserter(scratch));
+			shared = target.size() + source.size() - scratch.size();
+			kept = target.size();
+			break;
+		case HashPackMergeMode::Intersection:
+			std::set_intersection(target.begin(), target.end(), source.begin(), source.end(), std::back_inserter(scratch));
+			shared = scratch.size();
+			kept = shared;
+			break;
+		case HashPackMergeMode::Replace:
+			std::set_intersection(target.begin(), target.end(), source.begin(), source.end(), std::back_inserter(scratch));
+			shared = scratch.size();
+			kept = shared;
+			scratch.assign(source.begin(), source.end());
+			break;
+		}
+
+		report.hashesAdded += static_cast<uint32_t>(scratch.size() - kept);
+		report.hashesRemoved += static_cast<uint32_t>(target.size() - kept);
+		report.duplicatesDropped += static_cast<uint32_t>(shared);
+
+		if (scratch == target)
+			return false;
+
+		target.swap(scratch);
+		return true;
+	}
+
+	void HashPackMergeReport::add(const HashPackMergeReport& other)
+	{
+		groupsMerged += other.groupsMerged;
+		groupsAdded += other.groupsAdded;
+		groupsSkipped += other.groupsSkipped;
+		hashesAdded += other.hashesAdded;
+		hashesRemoved += other.hashesRemoved;
+		duplicatesDropped += other.duplicatesDropped;
+	}
+
+	std::string HashPackMergeReport::toString() const
+	{
+		return std::to_string(groupsMerged) + " groups merged, "
+			+ std::to_string(groupsAdded) + " added, "
+			+ std::to_string(groupsSkipped) + " skipped; "
+			+ std::to_string(hashesAdded) + " hashes added, "
+			+ std::to_string(hashesRemoved) + " removed, "
+			+ std::to_string(duplicatesDropped) + " duplicates dropped";
+	}
+
+	bool HashPackMerge::read(CDataFile& iniFile, HashPack& pack)
+	{
+		pack.groups.clear();
+		pack.duplicatesInFile = 0;
+
+		bool usingCustomFormat = true;
+		const int numberOfGroups = getGroupCount(iniFile, usingCustomFormat);
+
+		if (numberOfGroups == INT_MIN)
+		{
+			HashPackGroup group;
+			group.name = "Default";
+			readHashSection(iniFile, "PixelShaders", group.pixelShaderHashes);
+			readHashSection(iniFile, "VertexShaders", group.vertexShaderHashes);
+			readHashSection(iniFile, "ComputeShaders", group.computeShaderHashes);
+			if (countHashes(group) == 0)
+				return false;
+
+			pack.duplicatesInFile = normalizeGroup(group);
+			pack.groups.push_back(std::move(group));
+			return true;
+		}
+
+		const int savedGroupHashFormat = iniFile.GetInt("GTGroupFormat", "General");
+		const bool packedHashes = savedGroupHashFormat != INT_MIN && savedGroupHashFormat >= PackedHashFormat;
+		const std::string prefix = usingCustomFormat ? "GTGroup" : "Group";
+
+		pack.groups.reserve(numberOfGroups > 0 ? static_cast<size_t>(numberOfGroups) : 0);
+		for (int i = 0; i < numberOfGroups; i++)
+		{
+			const std::string sectionRoot = prefix + std::to_string(i);
+
+			HashPackGroup group;
+			group.name = iniFile.GetValue("Name", sectionRoot);
+			if (group.name.empty())
+				group.name = "Default";
+
+			if (packedHashes)
+			{
+				parseHashList(iniFile.GetValue("PixelShaderHashes", sectionRoot), group.pixelShaderHashes);
+				parseHashList(iniFile.GetValue("VertexShaderHashes", sectionRoot), group.vertexShaderHashes);
+				parseHashList(iniFile.GetValue("ComputeShaderHashes", sectionRoot), group.computeShaderHashes);
+			}
+			else
+			{
+				readHashSection(iniFile, sectionRoot + "_PixelShaders", group.pixelShaderHashes);
+				readHashSection(iniFile, sectionRoot + "_VertexShaders", group.vertexShaderHashes);
+				readHashSection(iniFile, sectionRoot + "_ComputeShaders", group.computeShaderHashes);
+			}
+
+			pack.duplicatesInFile += normalizeGroup(group);
+			pack.groups.push_back(std::move(group));
+		}
+
+		return !pack.groups.empty();
+	}
+
+	HashPackMergeReport HashPackMerge::merge(HashPack& target, const HashPack& source, HashPackMergeMode mode)
+	{
+		HashPackMergeReport report;
+		report.duplicatesDropped = source.duplicatesInFile;
+
+		// a name the target has twice resolves to its first group, as does a name the pack has twice.
+		std::unordered_map<std::string, size_t> groupByName;
+		for (size_t i = 0; i < target.groups.size(); ++i)
+			groupByName.emplace(toLowerName(target.groups[i].name), i);
+
+		std::vector<uint32_t> scratch;
+		for (const HashPackGroup& sourceGroup : source.groups)
+		{
+			std::string lowerName = toLowerName(sourceGroup.name);
+			const auto match = groupByName.find(lowerName);
+			if (match == groupByName.end())
+			{
+				if (mode == HashPackMergeMode::Intersection)
+				{
+					++report.groupsSkipped;
+					continue;
+				}
+
+				groupByName.emplace(std::move(lowerName), target.groups.size());
+				target.groups.push_back(sourceGroup);
+				target.groups.back().changed = true;
+				++report.groupsAdded;
+				report.hashesAdded += static_cast<uint32_t>(countHashes(sourceGroup));
+				continue;
+			}
+
+			HashPackGroup& targetGroup = target.groups[match->second];
+			bool changed = mergeHashList(targetGroup.pixelShaderHashes, sourceGroup.pixelShaderHashes, mode, scratch, report);
+			changed |= mergeHashList(targetGroup.vertexShaderHashes, sourceGroup.vertexShaderHashes, mode, scratch, report);
+			changed |= mergeHashList(targetGroup.computeShaderHashes, sourceGroup.computeShaderHashes, mode, scratch, report);
+			if (changed)
+				targetGroup.changed = true;
+			++report.groupsMerged;
+		}
+
+		return report;
+	}
+
+	void HashPackMerge::write(CDataFile& iniFile, const HashPack& pack)
+	{
+		bool usingCustomFormat = true;
+		if (getGroupCount(iniFile, usingCustomFormat) == INT_MIN)
+		{
+			// the single-group layout becomes group 0 of the current one.
+			usingCustomFormat = true;
+			iniFile.DeleteSection("PixelShaders");
+			iniFile.DeleteSection("VertexShaders");
+			iniFile.DeleteSection("ComputeShaders");
+		}
+
+		const std::string prefix = usingCustomFormat ? "GTGroup" : "Group";
+		for (size_t i = 0; i < pack.groups.size(); ++i)
+		{
+			const HashPackGroup& group = pack.groups[i];
+			const std::string sectionRoot = prefix + std::to_string(i);
+
+			iniFile.SetValue("Name", group.name, "", sectionRoot);
+			iniFile.SetValue("VertexShaderHashes", formatHashList(group.vertexShaderHashes), "", sectionRoot);
+			iniFile.SetValue("PixelShaderHashes", formatHashList(group.pixelShaderHashes), "", sectionRoot);
+			iniFile.SetValue("ComputeShaderHashes", formatHashList(group.computeShaderHashes), "", sectionRoot);
+
+			// the per-key sections of the legacy format would be stale next to the packed lists.
+			iniFile.DeleteSection(sectionRoot + "_VertexShaders");
+			iniFile.DeleteSection(sectionRoot + "_PixelShaders");
+			iniFile.DeleteSection(sectionRoot + "_ComputeShaders");
+		}
+
+		iniFile.SetInt(usingCustomFormat ? "GTAmountGroups" : "AmountGroups", static_cast<int>(pack.groups.size()), "", "General");
+		iniFile.SetInt("GTGroupFormat", PackedHashFormat, "", "General");
+	}
+
+	void HashPackMerge::parseHashList(std::string_view packed, std::vector<uint32_t>& hashes)
+	{
+		if (packed.empty())
+			return;
+
+		hashes.reserve(hashes.size() + countPackedValues(packed));
+		forEachPackedHash(packed, [&hashes](uint32_t hash) { hashes.push_back(hash); });
+	}
+
+	void HashPackMerge::parseHashList(std::string_view packed, std::unordered_set<uint32_t>& hashes)
+	{
+		if (packed.empty())
+			return;
+
+		hashes.reserve(hashes.size() + countPackedValues(packed));
+		forEachPackedHash(packed, [&hashes](uint32_t hash) { hashes.insert(hash); });
+	}
+
+	std::string HashPackMerge::formatHashList(const std::vector<uint32_t>& sortedHashes)
+	{
+		static const char hexDigits[] = "0123456789ABCDEF";
+
+		std::string packed;
+		packed.reserve(sortedHashes.size() * 9);
+		for (const uint32_t hash : sortedHashes)
+		{
+			if (!packed.empty())
+				packed += ',';
+			for (int shift = 28; shift >= 0; shift -= 4)
+				packed += hexDigits[(hash >> shift) & 0xF];
+		}
+
+		return packed;
+	}
+
+	const char* HashPackMerge::getModeName(HashPackMergeMode mode)
+	{
+		switch (mode)
+		{
+		case HashPackMergeMode::Intersection:
+			return "Intersection";
+		case HashPackMergeMode::Replace:
+			return "Replace";
+		case HashPackMergeMode::Union:
+		default:
+			return "Union";
+		}
+	}
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+class CDataFile;
+
+namespace ShaderToggler
+{
+	enum class HashPackMergeMode
+	{
+		// adds the pack's hashes to the group of the same name, and adds the groups the target doesn't have.
+		Union = 0,
+		// keeps only the hashes a group shares with the pack's group of the same name. Other groups are left alone.
+		Intersection,
+		// replaces a group's hashes with those of the pack's group, and adds the groups the target doesn't have.
+		Replace,
+	};
+
+	// Name and shader hashes of one group. Every hash list is sorted ascending and free of duplicates.
+	struct HashPackGroup
+	{
+		std::string name;
+		std::vector<uint32_t> pixelShaderHashes;
+		std::vector<uint32_t> vertexShaderHashes;
+		std::vector<uint32_t> computeShaderHashes;
+		// set by merge() when the group was added or its hashes changed.
+		bool changed = false;
+	};
+
+	struct HashPack
+	{
+		std::vector<HashPackGroup> groups;
+		// hashes listed more than once within a group of the file; read() drops them.
+		uint32_t duplicatesInFile = 0;
+	};
+
+	struct HashPackMergeReport
+	{
+		uint32_t groupsMerged = 0;
+		uint32_t groupsAdded = 0;
+		uint32_t groupsSkipped = 0;
+		uint32_t hashesAdded = 0;
+		uint32_t hashesRemoved = 0;
+		// pack hashes the target group already had, plus the duplicates within the pack itself.
+		uint32_t duplicatesDropped = 0;
+
+		void add(const HashPackMergeReport& other);
+		std::string toString() const;
+	};
+
+	// Merges the groups of another ShaderToggler.ini, or of a pack file in the same layout, into a set of groups.
+	// Only group names and shader hashes take part; groups are matched by name, ignoring case. Needs nothing but
+	// CDataFile, so the hashpackmerge tool builds it outside Windows as well.
+	class HashPackMerge
+	{
+	public:
+		// Reads the groups of a loaded INI: the current and the original group layout, packed or per-key hashes,
+		// and the single-group layout of the first ShaderToggler versions. Returns false if it has no groups.
+		static bool read(CDataFile& iniFile, HashPack& pack);
+		static HashPackMergeReport merge(HashPack& target, const HashPack& source, HashPackMergeMode mode);
+		// Writes names and hashes of all groups back in the packed format. Groups beyond the file's count are
+		// added with just a name and hashes; everything else in the file is kept.
+		static void write(CDataFile& iniFile, const HashPack& pack);
+
+		// Appends the hashes of a packed list (hex values separated by commas) in file order.
+		static void parseHashList(std::string_view packed, std::vector<uint32_t>& hashes);
+		// Inserts the hashes of a packed list straight into a set, without a temporary list.
+		static void parseHashList(std::string_view packed, std::unordered_set<uint32_t>& hashes);
+		// Packs a sorted list as 8-digit uppercase hex values separated by commas.
+		static std::string formatHashList(const std::vector<uint32_t>& sortedHashes);
+
+		static const char* getModeName(HashPackMergeMode mode);
+	};
+}
@@ -7,13 +7,15 @@
 /////////////////////////////////////////////////////////////////////////GT
 
 #include "KeyData.h"
+#include "GamepadPoller.h"
 #include <Xinput.h>
-#include <Windows.h>
+#include <windows.h>
 #include <cfgmgr32.h>
 #include <string>
 #include <vector>
 #include <cwchar>
 #include <cstring>
+#include <bit>
 //GT
 #pragma comment(lib, "Cfgmgr32.lib")
 
@@ -151,6 +153,18 @@ namespace ShaderToggler
 			}
 		}
 
+		static bool isGamepadCodeDownInState(const XINPUT_STATE& state, uint8_t code)
+		{
+			if (code == GPAD_LT)
+				return state.Gamepad.bLeftTrigger > GPAD_TRIGGER_THRESHOLD;
+
+			if (code == GPAD_RT)
+				return state.Gamepad.bRightTrigger > GPAD_TRIGGER_THRESHOLD;
+
+			const WORD mask = gamepadCodeToButtonMask(code);
+			return mask != 0 && (state.Gamepad.wButtons & mask) != 0;
+		}
+
 		static std::string toLowerAscii(const std::string& input)
 		{
 			std::string out = input;
@@ -193,6 +207,84 @@ namespace ShaderToggler
 				containsInsensitive(deviceText, "wireless controller") ||
 				containsInsensitive(deviceText, "vid_054c");
 		}
+
+		static bool detectPlayStationControllerDevice()
+		{
+			XINPUT_STATE state = {};
+			if (!tryGetXInputState(0, state))
+				return false;
+
+			ULONG charCount = 0;
+			if (CM_Get_Device_ID_List_SizeW(&charCount, nullptr, CM_GETIDLIST_FILTER_PRESENT) != CR_SUCCESS || charCount == 0)
+				return false;
+
+			std::vector<wchar_t> deviceList(static_cast<size_t>(charCount) + 2, L'\0');
+			if (CM_Get_Device_ID_ListW(nullptr, deviceList.data(), static_cast<ULONG>(deviceList.size()), CM_GETIDLIST_FILTER_PRESENT) != CR_SUCCESS)
+				return false;
+
+			for (const wchar_t* current = deviceList.data(); *current != L'\0'; current += std::wcslen(current) + 1)
+			{
+				const std::string deviceId = wideToUtf8(current);
+				if (looksLikePlayStationDeviceString(deviceId))
+					return true;
+			}
+
+			return false;
+		}
+
+		static GamepadCodeMask toGamepadCodeMask(const XINPUT_STATE& state)
+		{
+			GamepadCodeMask mask = 0;
+			for (int code = GPAD_A; code <= GPAD_RT; ++code)
+			{
+				if (isGamepadCodeDownInState(state, static_cast<uint8_t>(code)))
+					mask |= static_cast<GamepadCodeMask>(1u << (code - GPAD_A));
+			}
+			return mask;
+		}
+
+		static bool isGamepadCodeInMask(GamepadCodeMask mask, uint8_t code)
+		{
+			return ((mask >> (code - GPAD_A)) & 1) != 0;
+		}
+
+		class XInputPollingBackend final : public GamepadPollingBackend
+		{
+		public:
+			bool pollDownCodes(GamepadCodeMask& downCodes) override
+			{
+				XINPUT_STATE state = {};
+				const bool connected = tryGetXInputState(0, state);
+				downCodes = connected ? toGamepadCodeMask(state) : 0;
+				return connected;
+			}
+
+			bool detectPlayStationController() override
+			{
+				return detectPlayStationControllerDevice();
+			}
+		};
+
+		static XInputPollingBackend s_xinputPollingBackend;
+		static GamepadPoller s_gamepadPoller;
+		static bool s_gamepadPollingEnabled = false;
+		static uint32_t s_gamepadPollingIntervalMs = 4;
+
+		// From the polling thread if it runs, otherwise polled on the calling thread.
+		static void readGamepadCodes(GamepadCodeMask& previous, GamepadCodeMask& current)
+		{
+			if (s_gamepadPoller.isRunning())
+			{
+				s_gamepadPoller.readDownCodes(previous, current);
+				return;
+			}
+
+			XINPUT_STATE prevState = {};
+			XINPUT_STATE currState = {};
+			pollGamepadState(prevState, currState);
+			previous = toGamepadCodeMask(prevState);
+			current = toGamepadCodeMask(currState);
+		}
 	}
 
 	KeyData::ControllerLabelMode KeyData::s_controllerLabelMode = KeyData::ControllerLabelMode::Auto;
@@ -233,6 +325,9 @@ namespace ShaderToggler
 		if (s_controllerLabelMode == ControllerLabelMode::Xbox)
 			return false;
 
+		if (s_gamepadPoller.isRunning())
+			return s_gamepadPoller.isPlayStationControllerDetected();
+
 		const DWORD now = GetTickCount();
 		if (now - s_lastControllerDetectTick > CONTROLLER_DETECT_REFRESH_MS)
 		{
@@ -244,32 +339,49 @@ namespace ShaderToggler
 
 	void KeyData::refreshControllerTypeDetection()
 	{
+		// the polling thread refreshes the detection itself.
+		if (s_gamepadPoller.isRunning())
+			return;
+
 		s_cachedPlayStationDetected = detectPlayStationController();
 		s_lastControllerDetectTick = GetTickCount();
 	}
 
 	bool KeyData::detectPlayStationController()
 	{
-		XINPUT_STATE state = {};
-		if (!tryGetXInputState(0, state))
-			return false;
+		return detectPlayStationControllerDevice();
+	}
 
-		ULONG charCount = 0;
-		if (CM_Get_Device_ID_List_SizeW(&charCount, nullptr, CM_GETIDLIST_FILTER_PRESENT) != CR_SUCCESS || charCount == 0)
-			return false;
+	void KeyData::setGamepadPollingThread(bool enabled, uint32_t pollIntervalMs)
+	{
+		s_gamepadPollingEnabled = enabled;
+		s_gamepadPollingIntervalMs = pollIntervalMs;
 
-		std::vector<wchar_t> deviceList(static_cast<size_t>(charCount) + 2, L'\0');
-		if (CM_Get_Device_ID_ListW(nullptr, deviceList.data(), static_cast<ULONG>(deviceList.size()), CM_GETIDLIST_FILTER_PRESENT) != CR_SUCCESS)
-			return false;
+		// started lazily by captureInputSnapshot() once a gamepad button is bound.
+		if (!enabled)
+			s_gamepadPoller.stop();
+		else
+			s_gamepadPoller.setPollIntervalMs(pollIntervalMs);
+	}
 
-		for (const wchar_t* current = deviceList.data(); *current != L'\0'; current += std::wcslen(current) + 1)
-		{
-			const std::string deviceId = wideToUtf8(current);
-			if (looksLikePlayStationDeviceString(deviceId))
-				return true;
-		}
+	bool KeyData::isGamepadPollingThreadEnabled()
+	{
+		return s_gamepadPollingEnabled;
+	}
+
+	uint32_t KeyData::getGamepadPollingIntervalMs()
+	{
+		return s_gamepadPollingIntervalMs;
+	}
 
-		return false;
+	bool KeyData::isGamepadPollingThreadRunning()
+	{
+		return s_gamepadPoller.isRunning();
+	}
+
+	void KeyData::stopGamepadPollingThread()
+	{
+		s_gamepadPoller.stop();
 	}
 // 01000111 01100001 01101101 01100101 01110100 01101001 01110011 01101101 00001010
 	bool KeyData::shouldUsePlayStationLabels()
@@ -451,47 +563,69 @@ namespace ShaderToggler
 
 	bool KeyData::isGamepadButtonDown(uint8_t code)
 	{
-		XINPUT_STATE prevState = {};
-		XINPUT_STATE currState = {};
-		pollGamepadState(prevState, currState);
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		readGamepadCodes(previous, current);
 
-		if (code == GPAD_LT)
-			return currState.Gamepad.bLeftTrigger > GPAD_TRIGGER_THRESHOLD;
-
-		if (code == GPAD_RT)
-			return currState.Gamepad.bRightTrigger > GPAD_TRIGGER_THRESHOLD;
+		return isGamepadCodeInMask(current, code);
+	}
 
-		const WORD mask = gamepadCodeToButtonMask(code);
-		if (mask == 0)
-			return false;
+	bool KeyData::isGamepadButtonPressed(uint8_t code)
+	{
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		readGamepadCodes(previous, current);
 
-		return (currState.Gamepad.wButtons & mask) != 0;
+		return isGamepadCodeInMask(current, code) && !isGamepadCodeInMask(previous, code);
 	}
 
-	bool KeyData::isGamepadButtonPressed(uint8_t code)
+	void KeyData::captureInputSnapshot(const reshade::api::effect_runtime* runtime, const InputKeyMask& interest, InputSnapshot& snapshot)
 	{
-		XINPUT_STATE prevState = {};
-		XINPUT_STATE currState = {};
-		pollGamepadState(prevState, currState);
+		snapshot = InputSnapshot();
+
+		InputKeyMask keyboardAndMouse = interest;
+		keyboardAndMouse.add(VK_MENU);
+		keyboardAndMouse.add(VK_SHIFT);
+		keyboardAndMouse.add(VK_CONTROL);
+		// Gamepad codes aren't virtual keys, they are filled in from a single XInput poll below.
+		keyboardAndMouse.bits[GPAD_A >> 6] &= ~(0xFFFFull << (GPAD_A & 63));
+		keyboardAndMouse.bits[0] &= ~1ull;
 
-		if (code == GPAD_LT)
+		for (int word = 0; word < 4; ++word)
 		{
-			return currState.Gamepad.bLeftTrigger > GPAD_TRIGGER_THRESHOLD &&
-				   prevState.Gamepad.bLeftTrigger <= GPAD_TRIGGER_THRESHOLD;
+			uint64_t remaining = keyboardAndMouse.bits[word];
+			while (remaining != 0)
+			{
+				const uint8_t code = static_cast<uint8_t>(word * 64 + std::countr_zero(remaining));
+				remaining &= remaining - 1;
+
+				if (runtime->is_key_down(code))
+					snapshot.down.add(code);
+				if (runtime->is_key_pressed(code))
+					snapshot.pressed.add(code);
+			}
 		}
 
-		if (code == GPAD_RT)
+		const uint64_t gamepadInterest = interest.bits[GPAD_A >> 6] & (0xFFFFull << (GPAD_A & 63));
+		if (gamepadInterest == 0)
+			return;
+
+		if (s_gamepadPollingEnabled && !s_gamepadPoller.isRunning())
 		{
-			return currState.Gamepad.bRightTrigger > GPAD_TRIGGER_THRESHOLD &&
-				   prevState.Gamepad.bRightTrigger <= GPAD_TRIGGER_THRESHOLD;
+			// XInput is loaded here, not on the polling thread.
+			initializeXInput();
+			s_gamepadPoller.start(s_xinputPollingBackend, s_gamepadPollingIntervalMs, CONTROLLER_DETECT_REFRESH_MS);
 		}
 
-		const WORD mask = gamepadCodeToButtonMask(code);
-		if (mask == 0)
-			return false;
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		readGamepadCodes(previous, current);
 
-		return ((currState.Gamepad.wButtons & mask) != 0) &&
-			   ((prevState.Gamepad.wButtons & mask) == 0);
+		// the polling thread also reports presses that were released again before this frame.
+		const GamepadCodeMask pressed = s_gamepadPoller.isRunning() ? s_gamepadPoller.takePressedCodes() : static_cast<GamepadCodeMask>(current & ~previous);
+		const uint64_t shift = GPAD_A & 63;
+		snapshot.down.bits[GPAD_A >> 6] |= (static_cast<uint64_t>(current) << shift) & gamepadInterest;
+		snapshot.pressed.bits[GPAD_A >> 6] |= (static_cast<uint64_t>(pressed) << shift) & gamepadInterest;
 	}
 
 	void KeyData::collectKeysPressed(const reshade::api::effect_runtime* runtime, bool allowMouseButtons)
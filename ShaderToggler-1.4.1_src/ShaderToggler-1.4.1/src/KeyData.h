@@ -31,6 +31,30 @@ namespace ShaderToggler
 			CtrlAltShift = 7
 		};
 
+		// Set of key codes (virtual keys, gamepad codes 240-255) as a 256-bit mask.
+		struct InputKeyMask
+		{
+			uint64_t bits[4] = {};
+
+			void add(uint8_t code) { bits[code >> 6] |= 1ull << (code & 63); }
+			bool contains(uint8_t code) const { return (bits[code >> 6] >> (code & 63)) & 1; }
+			bool intersects(const InputKeyMask& other) const
+			{
+				return ((bits[0] & other.bits[0]) | (bits[1] & other.bits[1]) | (bits[2] & other.bits[2]) | (bits[3] & other.bits[3])) != 0;
+			}
+		};
+
+		// Input state captured once per frame, so bindings are evaluated with bit tests instead of
+		// runtime queries per binding. Only the keys in the interest mask and the modifiers are captured.
+		struct InputSnapshot
+		{
+			InputKeyMask down;
+			InputKeyMask pressed;
+
+			bool isDown(uint8_t code) const { return down.contains(code); }
+			bool isPressed(uint8_t code) const { return pressed.contains(code); }
+		};
+
 		KeyData();
 
 		void setKeyFromIniFile(uint32_t newKeyValue);
@@ -41,6 +65,13 @@ namespace ShaderToggler
 		void collectKeysPressed(const reshade::api::effect_runtime* runtime, bool allowMouseButtons = true);
 
 		static void setMouseHotkeysBlocked(bool blocked);
+		static void captureInputSnapshot(const reshade::api::effect_runtime* runtime, const InputKeyMask& interest, InputSnapshot& snapshot);
+
+		void addToInputKeyMask(InputKeyMask& mask) const
+		{
+			if (_keyCode)
+				mask.add(_keyCode);
+		}
 
 		bool isKeyDown(const reshade::api::effect_runtime* runtime) const
 		{
@@ -70,6 +101,28 @@ namespace ShaderToggler
 
 		bool isKeyPressed(const reshade::api::effect_runtime* runtime) const;
 
+		bool isKeyDown(const InputSnapshot& input) const
+		{
+			if (!_keyCode)
+				return false;
+
+			if (isMouseCode(_keyCode) && s_mouseHotkeysBlocked)
+				return false;
+
+			return input.isDown(_keyCode) && (isGamepadCode(_keyCode) || areModifiersMatching(input));
+		}
+
+		bool isKeyPressed(const InputSnapshot& input) const
+		{
+			if (!_keyCode)
+				return false;
+
+			if (isMouseCode(_keyCode) && s_mouseHotkeysBlocked)
+				return false;
+
+			return input.isPressed(_keyCode) && (isGamepadCode(_keyCode) || areModifiersMatching(input));
+		}
+
 		std::string getKeyAsString() const { return toString(); }
 		uint8_t getKeyCode() const { return _keyCode; }
 		bool isValid() const { return _keyCode > 0; }
@@ -83,6 +136,13 @@ namespace ShaderToggler
 		static bool isPlayStationControllerDetected();
 		static void refreshControllerTypeDetection();
 
+		// Polls the gamepad on a separate thread instead of on the present thread.
+		static void setGamepadPollingThread(bool enabled, uint32_t pollIntervalMs);
+		static bool isGamepadPollingThreadEnabled();
+		static uint32_t getGamepadPollingIntervalMs();
+		static bool isGamepadPollingThreadRunning();
+		static void stopGamepadPollingThread();
+
 		static void setGlobalHotkeyModifier(GlobalHotkeyModifier modifier);
 		static GlobalHotkeyModifier getGlobalHotkeyModifier();
 		static const char* globalHotkeyModifierToString(GlobalHotkeyModifier modifier);
@@ -109,6 +169,13 @@ namespace ShaderToggler
 		static bool globalModifierRequiresAlt();
 		static bool globalModifierRequiresShift();
 
+		bool areModifiersMatching(const InputSnapshot& input) const
+		{
+			return (_altRequired || globalModifierRequiresAlt()) == input.isDown(VK_MENU) &&
+				(_shiftRequired || globalModifierRequiresShift()) == input.isDown(VK_SHIFT) &&
+				(_ctrlRequired || globalModifierRequiresCtrl()) == input.isDown(VK_CONTROL);
+		}
+
 		uint8_t _keyCode;
 		bool _shiftRequired;
 		bool _altRequired;
@@ -21,21 +21,33 @@
 #include <reshade.hpp>
 #include "crc32_hash.hpp"
 #include "ShaderManager.h"
+#include "ShaderActivityHistory.h"
+#include "GroupDeadlineScheduler.h"
+#include "AllocationCounter.h"
+#include "ConfigPersistenceWorker.h"
+#include "ConfigCache.h"
+#include "HashPackMerge.h"
 #include "CDataFile.h"
 #include "ToggleGroup.h"
 #include "KeyData.h"
 #include <vector>
 #include <filesystem>
-#include <Windows.h>
+#include <windows.h>
 #include <chrono>
 #include <algorithm>
 #include <atomic>
+#include <mutex>
+#include <future>
 #include <string>
 #include <fstream>
 #include <cstring>
+#include <charconv>
 #include <cstdio>
 #include <unordered_map>
 #include <unordered_set>
+#include <optional>
+#include <array>
+#include <bit>
 
 #ifdef min
 #undef min
@@ -52,19 +64,48 @@ using namespace ShaderToggler;
 extern "C" __declspec(dllexport) const char *NAME = "Shader Toggler";
 extern "C" __declspec(dllexport) const char *DESCRIPTION = "Add-on which allows you to define groups of game shaders to toggle on/off with one key press.";
 
+// Shader registries of one device. Pipeline handles are only unique per device, so each device gets its
+// own set in init_device, and destroy_device drops them in one go.
+struct __declspec(uuid("5E1D7C2B-8A44-4F0E-9B13-6C2A1D9F4E70")) DeviceDataContainer
+{
+	ShaderManager pixelShaderManager;
+	ShaderManager vertexShaderManager;
+	ShaderManager computeShaderManager;
+};
+
 struct __declspec(uuid("038B03AA-4C75-443B-A695-752D80797037")) CommandListDataContainer
 {
+	DeviceDataContainer* deviceData;
 	uint64_t activePixelShaderPipeline;
 	uint64_t activeVertexShaderPipeline;
 	uint64_t activeComputeShaderPipeline;
+
+	// Block verdict for the bound pipelines, valid for one frame epoch; binding a known pipeline drops it.
+	uint32_t verdictFrameEpoch;
+	bool hasCachedVerdict;
+	bool cachedVerdictBlocks;
 };
 
 #define FRAMECOUNT_COLLECTION_PHASE_DEFAULT 250
+#define BACKGROUND_SAMPLING_MAX_FRAME_INTERVAL 8
+#define BACKGROUND_SAMPLING_BUDGET_NS 150
+#define BACKGROUND_SAMPLING_MEASURE_EVERY_NTH_BIND 256
+#define SHADER_ACTIVITY_HISTORY_MAX_FRAMES 600
+#define SHADER_ACTIVITY_HISTORY_MAX_BYTES_PER_STAGE (4 * 1024 * 1024)
+#define GAMEPAD_POLLING_INTERVAL_MS_DEFAULT 4
+#define GAMEPAD_POLLING_INTERVAL_MS_MAX 50
+#define PRIMARY_EFFECT_RUNTIME_TIMEOUT_MS 250
+#define CONFIG_SAVE_DEBOUNCE_MS 500
+#define CONFIG_SAVE_MAX_DELAY_MS 3000
+#define CONFIG_RELOAD_POLL_INTERVAL_MS 1000
 #define HASH_FILE_NAME L"ShaderToggler.ini"
 
-static ShaderManager g_pixelShaderManager;
-static ShaderManager g_vertexShaderManager;
-static ShaderManager g_computeShaderManager;
+// All live devices, for settings that apply to every registry. Hunting, collection and the overlay work on
+// the device of the primary effect runtime; the detached set stands in while there is none.
+static std::mutex g_deviceRegistryMutex;
+static std::vector<DeviceDataContainer*> g_deviceRegistry;
+static std::atomic<DeviceDataContainer*> g_huntingDeviceData = nullptr;
+static DeviceDataContainer g_detachedDeviceData;
 static KeyData g_keyCollector;
 static std::atomic_uint32_t g_activeCollectorFrameCounter = 0;
 static std::vector<ToggleGroup> g_toggleGroups;
@@ -84,37 +125,190 @@ static std::unordered_set<int> g_pendingSuspendedGroupToggles;
 static float g_overlayOpacity = 1.0f;
 static int g_startValueFramecountCollectionPhase = FRAMECOUNT_COLLECTION_PHASE_DEFAULT;
 static std::filesystem::path g_iniFileName;
+// Saves from the settings window are written off the render thread; see saveShaderTogglerIniFile().
+static ConfigPersistenceWorker g_configPersistence;
+// Held while the save and controller threads run, so the add-on can't be unloaded under them: DllMain can't wait
+// for a thread. Both start in present and stop in destroy_effect_runtime.
+static HMODULE g_workerThreadModuleReference = nullptr;
+
+// Config loading and controller detection run on a thread started from DllMain, which only begins once the
+// loader lock is released. Everything that reads the config (creating device data, present) first waits for it in
+// finishDeferredInit(), so the loaded groups are published as a whole before the first draw is filtered.
+// The thread holds its own reference on the module, so DllMain never has to wait for it on detach.
+static std::once_flag g_deferredInitOnce;
+static std::atomic_bool g_deferredInitFinished = false;
+
+// Hot reload: present checks the INI's write time and size every CONFIG_RELOAD_POLL_INTERVAL_MS. A changed file
+// is parsed on a background task and diffed against the live groups by the next present. A change that comes
+// with a new write count of g_configPersistence is the add-on's own save and is only remembered; while one of its
+// writes is in progress the file isn't looked at.
+struct IniFileStamp
+{
+	std::filesystem::file_time_type writeTime;
+	uintmax_t size = 0;
+	bool exists = false;
+
+	bool operator==(const IniFileStamp& other) const = default;
+};
+static IniFileStamp g_iniFileStamp;
+static uint32_t g_iniFileStampWrites = 0;
+static std::chrono::steady_clock::time_point g_iniFileLastPoll;
+static std::future<std::unique_ptr<CDataFile>> g_iniReloadParse;
+// Binary sidecar of the INI (see ConfigCache); startup reads it instead of parsing the INI while it matches.
+static bool g_configCacheEnabled = true;
+static bool g_configLoadedFromCache = false;
+// Hash pack import: another ShaderToggler.ini or a pack file in the same layout, merged per group by name.
+static char g_hashPackImportPath[260] = "";
+static int g_hashPackImportMode = static_cast<int>(HashPackMergeMode::Union);
+static std::string g_hashPackImportResult;
+
+// With several swapchains (VR eyes, mirror windows, tool windows) every effect runtime presents. Only
+// one of them, the primary, runs the group/input/timer pass so a displayed frame is counted once. A
+// runtime that stops presenting for longer than PRIMARY_EFFECT_RUNTIME_TIMEOUT_MS hands the role over.
+static std::atomic<effect_runtime*> g_primaryEffectRuntime = nullptr;
+static std::atomic<std::chrono::steady_clock::rep> g_primaryEffectRuntimeLastPresent = 0;
+
+// Background sampling keeps a per-hash 'last seen frame' stamp up to date so hunting can start
+// without a collection phase. Every Nth bind is timed; when the average cost goes over the budget
+// the sampling interval backs off to every 2nd, 4th ... frame.
+static std::atomic_uint32_t g_frameEpoch = 0;
+static std::atomic_bool g_backgroundSamplingEnabled = false;
+static std::atomic_uint32_t g_backgroundSamplingFrameInterval = 1;
+static std::atomic_bool g_backgroundSamplingThisFrame = false;
+static std::atomic_uint32_t g_backgroundSamplingBindCounter = 0;
+static std::atomic_uint64_t g_backgroundSamplingMeasuredNs = 0;
+static std::atomic_uint32_t g_backgroundSamplingMeasuredBinds = 0;
+static float g_backgroundSamplingAverageNs = 0.0f;
+static std::chrono::steady_clock::time_point g_backgroundSamplingLastBudgetCheck;
+
+// Per-stage history of the sampled frames, so 'what became active in frame F compared to k frames
+// earlier' can be answered after the fact.
+static ShaderActivityHistory g_pixelShaderActivityHistory(SHADER_ACTIVITY_HISTORY_MAX_FRAMES, SHADER_ACTIVITY_HISTORY_MAX_BYTES_PER_STAGE);
+static ShaderActivityHistory g_vertexShaderActivityHistory(SHADER_ACTIVITY_HISTORY_MAX_FRAMES, SHADER_ACTIVITY_HISTORY_MAX_BYTES_PER_STAGE);
+static ShaderActivityHistory g_computeShaderActivityHistory(SHADER_ACTIVITY_HISTORY_MAX_FRAMES, SHADER_ACTIVITY_HISTORY_MAX_BYTES_PER_STAGE);
+static std::vector<uint64_t> g_shaderActivityBitsScratch;
+static int g_shaderActivityFramesAgo = 0;
+static int g_shaderActivityCompareFrames = 30;
+static HuntCandidateFilter g_huntCandidateFilter = HuntCandidateFilter::All;
+
+// Time and epoch of the frame being presented, captured once per present of the primary runtime. Group
+// timers, suspension and hunting repeats all use it, so a frame never sees two different 'now' values. The
+// settings window runs between presents and uses the clock of the last presented frame. Draw verdicts and
+// the background sampling's last-seen stamps use the same epoch through g_frameEpoch.
+struct FrameClock
+{
+	std::chrono::steady_clock::time_point now;
+	uint32_t epoch = 0;
+};
+static FrameClock g_frameClock;
+
+// Runtime state of the present loop per group, at the same slot as the group in g_toggleGroups.
+// An empty optional means 'not running'. syncGroupRuntimeStates() realigns it by group id after
+// groups were added, removed, duplicated or reordered.
+struct GroupRuntimeState
+{
+	int groupId = -1;
+	bool hotkeyWasDown = false;
+	std::chrono::steady_clock::time_point hotkeyLastToggleTime;
+	std::optional<std::chrono::steady_clock::time_point> lastTimedTriggerTime;
+	std::optional<std::chrono::steady_clock::time_point> timedVisibleSince;
+	std::optional<std::chrono::steady_clock::time_point> timedFadeOutStart;
+	std::optional<std::chrono::steady_clock::time_point> lastTimedSuppressionInputTime;
+	std::optional<std::chrono::steady_clock::time_point> startupActivationStartTime;
+	bool updateQueued = false;
+};
 
-// 
-static std::unordered_map<int, bool> g_groupHotkeyWasDown;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupHotkeyLastToggleTime;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupLastTimedTriggerTime;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupTimedVisibleSince;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupTimedFadeOutStart;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupLastTimedSuppressionInputTime;
-static std::unordered_map<int, std::chrono::steady_clock::time_point> g_groupStartupActivationStartTime;
+static std::vector<GroupRuntimeState> g_groupRuntimeStates;
+// Groups are only updated on a binding key edge or an expired deadline. A full pass over all groups is done
+// after the group list or its timers changed outside the present loop (realign, restore, settings UI).
+static GroupDeadlineScheduler g_groupDeadlineScheduler;
+static bool g_groupFullUpdatePending = true;
+static std::vector<uint32_t> g_groupUpdateSlots;
+static size_t g_groupsUpdatedThisFrame = 0;
+
+// Hotkey dispatch index: for every key code the slots of the groups that use it as toggle, timed trigger or
+// suppression key, as one flat array with per-code offsets. Rebuilt when a binding or the group list changed.
+static std::array<uint32_t, 257> g_hotkeyDispatchOffsets = {};
+static std::vector<uint32_t> g_hotkeyDispatchSlots;
+static uint32_t g_hotkeyDispatchGroupRevision = 0;
+static bool g_hotkeyDispatchDirty = true;
+static bool g_hotkeyDispatchHunting = false;
+static KeyData::InputKeyMask g_previousInputDown;
 static const int g_groupHotkeyDebounceMs = 150;
 
-// 
-static std::chrono::steady_clock::time_point s_lastNP1, s_lastNP2, s_lastNP4, s_lastNP5, s_lastNP7, s_lastNP8;
-static std::chrono::steady_clock::time_point s_holdStartNP1, s_holdStartNP2, s_holdStartNP4, s_holdStartNP5, s_holdStartNP7, s_holdStartNP8;
-static bool s_np1Held = false, s_np2Held = false, s_np4Held = false, s_np5Held = false, s_np7Held = false, s_np8Held = false;
+// Per-group digests of the config stamp, keyed by group id. An entry is reused as long as the group's revision
+// is unchanged, so recomputing the stamp on save only re-hashes the groups that were edited.
+struct GroupSignatureCacheEntry
+{
+	uint64_t digest = 0;
+	uint32_t revision = 0;
+	uint32_t generation = 0;
+	bool valid = false;
+};
 
-//
-static bool s_prevNP1Down = false;
-static bool s_prevNP2Down = false;
-static bool s_prevNP3Down = false;
-static bool s_prevNP4Down = false;
-static bool s_prevNP5Down = false;
-static bool s_prevNP6Down = false;
-static bool s_prevNP7Down = false;
-static bool s_prevNP8Down = false;
-static bool s_prevNP9Down = false;
-
-static const int s_holdRepeatStartMs = 200;
-static const int s_holdRepeatMidMs = 120;
-static const int s_holdRepeatFastMs = 70;
-static const int s_holdRepeatVeryFastMs = 35;
+static std::unordered_map<ToggleGroup::GroupId, GroupSignatureCacheEntry> g_groupSignatureCache;
+static uint32_t g_groupSignatureGeneration = 0;
+
+// Hunting navigation keys. Each entry is one key, what it does and on which shader stage; previous/next repeat
+// while held, with an interval from g_huntingRepeatCurve. Only polled while a shader manager is hunting.
+enum class HuntingAction
+{
+	Previous,
+	Next,
+	ToggleMark
+};
+
+struct HuntingNavigationBinding
+{
+	uint8_t keyCode;
+	ShaderManager DeviceDataContainer::* shaderManager;
+	HuntingAction action;
+	const char* stageName;
+};
+
+struct HuntingNavigationKeyState
+{
+	bool wasDown = false;
+	bool held = false;
+	std::chrono::steady_clock::time_point holdStart;
+	std::chrono::steady_clock::time_point lastRepeat;
+};
+
+// Repeat interval while a key is held: intervalMs[i] once it is held for at least heldMs[i - 1].
+struct HoldRepeatCurve
+{
+	uint32_t heldMs[3] = { 700, 1400, 2400 };
+	uint32_t intervalMs[4] = { 200, 120, 70, 35 };
+
+	uint32_t getIntervalMs(long long heldForMs) const
+	{
+		int step = 0;
+		while (step < 3 && heldForMs >= static_cast<long long>(heldMs[step]))
+			++step;
+		return intervalMs[step];
+	}
+};
+
+static const int g_huntingNavigationKeyCount = 9;
+static HuntingNavigationBinding g_huntingNavigationBindings[g_huntingNavigationKeyCount] =
+{
+	{ VK_NUMPAD1, &DeviceDataContainer::pixelShaderManager, HuntingAction::Previous, "pixel" },
+	{ VK_NUMPAD2, &DeviceDataContainer::pixelShaderManager, HuntingAction::Next, "pixel" },
+	{ VK_NUMPAD3, &DeviceDataContainer::pixelShaderManager, HuntingAction::ToggleMark, "pixel" },
+	{ VK_NUMPAD4, &DeviceDataContainer::vertexShaderManager, HuntingAction::Previous, "vertex" },
+	{ VK_NUMPAD5, &DeviceDataContainer::vertexShaderManager, HuntingAction::Next, "vertex" },
+	{ VK_NUMPAD6, &DeviceDataContainer::vertexShaderManager, HuntingAction::ToggleMark, "vertex" },
+	{ VK_NUMPAD7, &DeviceDataContainer::computeShaderManager, HuntingAction::Previous, "compute" },
+	{ VK_NUMPAD8, &DeviceDataContainer::computeShaderManager, HuntingAction::Next, "compute" },
+	{ VK_NUMPAD9, &DeviceDataContainer::computeShaderManager, HuntingAction::ToggleMark, "compute" },
+};
+static HuntingNavigationKeyState g_huntingNavigationKeyStates[g_huntingNavigationKeyCount];
+static std::string g_huntingNavigationKeyNames[g_huntingNavigationKeyCount] =
+{
+	"Numpad 1", "Numpad 2", "Numpad 3", "Numpad 4", "Numpad 5", "Numpad 6", "Numpad 7", "Numpad 8", "Numpad 9"
+};
+static HoldRepeatCurve g_huntingRepeatCurve;
+static bool g_huntingNavigationActive = false;
 
 //
 static const char* GT_CREATOR = "Gametism";
@@ -139,40 +333,145 @@ static const char* GT_FOOTER =
 	"; ==========================================\n";
 
 static bool g_uiStyleInitialized = false;
+static KeyData::InputKeyMask g_hotkeyInterestMask;
+static KeyData::InputSnapshot g_inputSnapshot;
 static std::chrono::steady_clock::time_point g_overlayMouseCaptureLastSeen;
 
-static bool is_key_down_numpad_only(reshade::api::effect_runtime* runtime, int vk_numpad)
+static DeviceDataContainer& getHuntingDeviceData()
 {
-	bool down = runtime->is_key_down(vk_numpad);
-	down = down || ((GetAsyncKeyState(vk_numpad) & 0x8000) != 0);
-	return down;
+	DeviceDataContainer* deviceData = g_huntingDeviceData.load();
+	return nullptr != deviceData ? *deviceData : g_detachedDeviceData;
 }
 
-static int getAcceleratedRepeatMs(const std::chrono::steady_clock::time_point& holdStart, const std::chrono::steady_clock::time_point& now)
+static DeviceDataContainer* getDeviceData(device* device)
 {
-	const auto heldMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - holdStart).count();
+	uint64_t deviceData = 0;
+	device->get_private_data(reinterpret_cast<const uint8_t*>(&__uuidof(DeviceDataContainer)), &deviceData);
+	return reinterpret_cast<DeviceDataContainer*>(static_cast<uintptr_t>(deviceData));
+}
+
+static bool isHuntingShaders()
+{
+	DeviceDataContainer& deviceData = getHuntingDeviceData();
+	return deviceData.pixelShaderManager.isInHuntingMode() || deviceData.vertexShaderManager.isInHuntingMode() || deviceData.computeShaderManager.isInHuntingMode();
+}
 
-	if (heldMs >= 2400)
-		return s_holdRepeatVeryFastMs;
-	if (heldMs >= 1400)
-		return s_holdRepeatFastMs;
-	if (heldMs >= 700)
-		return s_holdRepeatMidMs;
+static bool isHuntingKeyDown(const KeyData::InputSnapshot& input, uint8_t keyCode)
+{
+	bool down = input.isDown(keyCode);
+	down = down || ((GetAsyncKeyState(keyCode) & 0x8000) != 0);
+	return down;
+}
 
-	return s_holdRepeatStartMs;
+static void runHuntingAction(DeviceDataContainer& deviceData, const HuntingNavigationBinding& binding, bool ctrlDown)
+{
+	ShaderManager& shaderManager = deviceData.*binding.shaderManager;
+	switch (binding.action)
+	{
+	case HuntingAction::Previous:
+		shaderManager.huntPreviousShader(ctrlDown);
+		break;
+	case HuntingAction::Next:
+		shaderManager.huntNextShader(ctrlDown);
+		break;
+	case HuntingAction::ToggleMark:
+		shaderManager.toggleMarkOnHuntedShader();
+		break;
+	}
 }
 
-static uint64_t fnv1a64(const std::string& text)
+static void updateHuntingNavigation(const KeyData::InputSnapshot& input, const std::chrono::steady_clock::time_point& now)
 {
-	uint64_t hash = 14695981039346656037ull;
-	for (unsigned char c : text)
+	if (!isHuntingShaders())
+	{
+		g_huntingNavigationActive = false;
+		return;
+	}
+
+	DeviceDataContainer& deviceData = getHuntingDeviceData();
+
+	// keys already down when hunting starts don't count as pressed.
+	const bool justStarted = !g_huntingNavigationActive;
+	g_huntingNavigationActive = true;
+
+	const bool ctrlDown = input.isDown(VK_CONTROL);
+
+	for (int i = 0; i < g_huntingNavigationKeyCount; ++i)
 	{
-		hash ^= static_cast<uint64_t>(c);
-		hash *= 1099511628211ull;
+		const HuntingNavigationBinding& binding = g_huntingNavigationBindings[i];
+		HuntingNavigationKeyState& state = g_huntingNavigationKeyStates[i];
+
+		const bool down = isHuntingKeyDown(input, binding.keyCode);
+		const bool pressed = down && !state.wasDown && !justStarted;
+		state.wasDown = down;
+
+		if (pressed)
+		{
+			runHuntingAction(deviceData, binding, ctrlDown);
+			state.held = binding.action != HuntingAction::ToggleMark;
+			state.holdStart = now;
+			state.lastRepeat = now;
+		}
+		else if (down && state.held &&
+			std::chrono::duration_cast<std::chrono::milliseconds>(now - state.lastRepeat).count() >=
+			g_huntingRepeatCurve.getIntervalMs(std::chrono::duration_cast<std::chrono::milliseconds>(now - state.holdStart).count()))
+		{
+			runHuntingAction(deviceData, binding, ctrlDown);
+			state.lastRepeat = now;
+		}
+		else if (!down)
+		{
+			state.held = false;
+		}
 	}
-	return hash;
 }
 
+static void setHuntingNavigationKey(int index, uint8_t keyCode)
+{
+	g_huntingNavigationBindings[index].keyCode = keyCode;
+
+	KeyData key;
+	key.setKey(keyCode);
+	g_huntingNavigationKeyNames[index] = key.getKeyAsString();
+}
+
+struct Fnv1a64Stream
+{
+	uint64_t state = 14695981039346656037ull;
+
+	void add(const char* data, size_t length)
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			state ^= static_cast<uint64_t>(static_cast<unsigned char>(data[i]));
+			state *= 1099511628211ull;
+		}
+	}
+
+	void add(const char* text) { add(text, strlen(text)); }
+	void add(const std::string& text) { add(text.data(), text.size()); }
+
+	template <typename T>
+	void addNumber(T value)
+	{
+		char buf[24];
+		const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+		add(buf, static_cast<size_t>(result.ptr - buf));
+	}
+
+	// Feeds "|<name><index>=<value>" without building the field string.
+	template <typename T>
+	void addField(const char* name, T value, int index = -1)
+	{
+		add("|");
+		add(name);
+		if (index >= 0)
+			addNumber(index);
+		add("=");
+		addNumber(value);
+	}
+};
+
 static std::string toHex64(uint64_t value)
 {
 	char buf[17] = {};
@@ -227,6 +526,55 @@ static int getHotkeyLayoutSortPriority(const ToggleGroup& group)
 	}
 }
 
+static void syncGroupRuntimeStates()
+{
+	bool inSync = g_groupRuntimeStates.size() == g_toggleGroups.size();
+	for (size_t slot = 0; inSync && slot < g_toggleGroups.size(); ++slot)
+	{
+		inSync = g_groupRuntimeStates[slot].groupId == g_toggleGroups[slot].getId();
+	}
+
+	if (inSync)
+	{
+		return;
+	}
+
+	std::vector<GroupRuntimeState> realigned(g_toggleGroups.size());
+	for (size_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+	{
+		const int groupId = g_toggleGroups[slot].getId();
+		const auto previous = std::find_if(g_groupRuntimeStates.begin(), g_groupRuntimeStates.end(),
+			[groupId](const GroupRuntimeState& state) { return state.groupId == groupId; });
+
+		if (previous != g_groupRuntimeStates.end())
+		{
+			realigned[slot] = *previous;
+		}
+		else
+		{
+			realigned[slot].groupId = groupId;
+		}
+	}
+
+	g_groupRuntimeStates = std::move(realigned);
+	g_groupDeadlineScheduler.reset(g_groupRuntimeStates.size());
+	g_groupFullUpdatePending = true;
+	g_groupUpdateSlots.clear();
+	g_groupUpdateSlots.reserve(g_groupRuntimeStates.size());
+	g_hotkeyDispatchDirty = true;
+}
+
+static const GroupRuntimeState* findGroupRuntimeState(const ToggleGroup& group)
+{
+	for (const auto& state : g_groupRuntimeStates)
+	{
+		if (state.groupId == group.getId())
+			return &state;
+	}
+
+	return nullptr;
+}
+
 static void sortToggleGroupsByHotkey()
 {
 	std::stable_sort(g_toggleGroups.begin(), g_toggleGroups.end(),
@@ -251,6 +599,7 @@ static void sortToggleGroupsByHotkey()
 			return toLowerCopy(a.getName()) < toLowerCopy(b.getName());
 		});
 
+	syncGroupRuntimeStates();
 	saveShaderTogglerIniFile();
 }
 
@@ -270,6 +619,7 @@ static void sortToggleGroupsByNameAZ()
 			return a.getId() < b.getId();
 		});
 
+	syncGroupRuntimeStates();
 	saveShaderTogglerIniFile();
 }
 
@@ -289,61 +639,48 @@ static void sortToggleGroupsByNameLength()
 			return a.getName() < b.getName();
 		});
 
+	syncGroupRuntimeStates();
 	saveShaderTogglerIniFile();
 }
 
-static void appendSortedHashesToSignature(std::string& data, const char* prefix, const std::unordered_set<uint32_t>& hashes)
-{
-	std::vector<uint32_t> sorted(hashes.begin(), hashes.end());
-	std::sort(sorted.begin(), sorted.end());
-
-	for (const auto value : sorted)
-	{
-		data += "|";
-		data += prefix;
-		data += "=";
-		data += std::to_string(value);
-	}
-}
-
-static bool isTimedTriggerBindingActive(const ToggleGroup::TimedTriggerBinding& binding, reshade::api::effect_runtime* runtime)
+static bool isTimedTriggerBindingActive(const ToggleGroup::TimedTriggerBinding& binding, const KeyData::InputSnapshot& input)
 {
 	switch (binding.mode)
 	{
 	case ToggleGroup::TimedTriggerMode::OnPress:
-		return binding.key.isKeyPressed(runtime);
+		return binding.key.isKeyPressed(input);
 	case ToggleGroup::TimedTriggerMode::WhileHeld:
-		return binding.key.isKeyDown(runtime);
+		return binding.key.isKeyDown(input);
 	case ToggleGroup::TimedTriggerMode::PressAndHold:
-		return binding.key.isKeyPressed(runtime) || binding.key.isKeyDown(runtime);
+		return binding.key.isKeyPressed(input) || binding.key.isKeyDown(input);
 	default:
-		return binding.key.isKeyPressed(runtime);
+		return binding.key.isKeyPressed(input);
 	}
 }
 
-static bool isAnyTimedTriggerActive(const ToggleGroup& group, reshade::api::effect_runtime* runtime)
+static bool isAnyTimedTriggerActive(const ToggleGroup& group, const KeyData::InputSnapshot& input)
 {
 	if (group.hasTimedTriggerKeys())
 	{
 		for (size_t i = 0; i < group.getTimedTriggerKeyCount(); ++i)
 		{
-			if (isTimedTriggerBindingActive(group.getTimedTriggerBindingAt(i), runtime))
+			if (isTimedTriggerBindingActive(group.getTimedTriggerBindingAt(i), input))
 				return true;
 		}
 		return false;
 	}
 
-	return group.getToggleKey().isKeyPressed(runtime);
+	return group.getToggleKey().isKeyPressed(input);
 }
 
-static bool isAnyTimedSuppressionKeyDown(const ToggleGroup& group, reshade::api::effect_runtime* runtime)
+static bool isAnyTimedSuppressionKeyDown(const ToggleGroup& group, const KeyData::InputSnapshot& input)
 {
 	if (!group.hasTimedSuppressionKeys())
 		return false;
 
 	for (size_t i = 0; i < group.getTimedSuppressionKeyCount(); ++i)
 	{
-		if (group.getTimedSuppressionKeyAt(i).isKeyDown(runtime))
+		if (group.getTimedSuppressionKeyAt(i).isKeyDown(input))
 			return true;
 	}
 
@@ -357,18 +694,18 @@ static void setGroupActiveWithEditRefresh(ToggleGroup& group, bool newActive)
 
 	if (group.getId() == g_toggleGroupIdShaderEditing && previousActive != newActive)
 	{
-		g_vertexShaderManager.toggleHideMarkedShaders();
-		g_pixelShaderManager.toggleHideMarkedShaders();
-		g_computeShaderManager.toggleHideMarkedShaders();
+		DeviceDataContainer& deviceData = getHuntingDeviceData();
+		deviceData.vertexShaderManager.toggleHideMarkedShaders();
+		deviceData.pixelShaderManager.toggleHideMarkedShaders();
+		deviceData.computeShaderManager.toggleHideMarkedShaders();
 	}
 }
 
 
-template <typename TMap>
-static void shiftTimePointMap(TMap& values, const std::chrono::steady_clock::duration& amount)
+static void shiftTimePoint(std::optional<std::chrono::steady_clock::time_point>& value, const std::chrono::steady_clock::duration& amount)
 {
-	for (auto& entry : values)
-		entry.second += amount;
+	if (value)
+		*value += amount;
 }
 
 static bool globalHotkeyExists(
@@ -391,20 +728,23 @@ static bool globalHotkeyExists(
 	return false;
 }
 
-static void restoreAllToggleGroups()
+static void restoreAllToggleGroups(const std::chrono::steady_clock::time_point& now)
 {
 	if (!g_allToggleGroupsSuspended)
 		return;
 
-	const auto now = std::chrono::steady_clock::now();
 	const auto pausedDuration = now - g_globalSuspensionStarted;
 
-	shiftTimePointMap(g_groupHotkeyLastToggleTime, pausedDuration);
-	shiftTimePointMap(g_groupLastTimedTriggerTime, pausedDuration);
-	shiftTimePointMap(g_groupTimedVisibleSince, pausedDuration);
-	shiftTimePointMap(g_groupTimedFadeOutStart, pausedDuration);
-	shiftTimePointMap(g_groupLastTimedSuppressionInputTime, pausedDuration);
-	shiftTimePointMap(g_groupStartupActivationStartTime, pausedDuration);
+	for (auto& state : g_groupRuntimeStates)
+	{
+		if (state.hotkeyLastToggleTime.time_since_epoch().count() != 0)
+			state.hotkeyLastToggleTime += pausedDuration;
+		shiftTimePoint(state.lastTimedTriggerTime, pausedDuration);
+		shiftTimePoint(state.timedVisibleSince, pausedDuration);
+		shiftTimePoint(state.timedFadeOutStart, pausedDuration);
+		shiftTimePoint(state.lastTimedSuppressionInputTime, pausedDuration);
+		shiftTimePoint(state.startupActivationStartTime, pausedDuration);
+	}
 
 	for (const int groupId : g_pendingSuspendedGroupToggles)
 	{
@@ -421,161 +761,257 @@ static void restoreAllToggleGroups()
 	g_pendingSuspendedGroupToggles.clear();
 	g_allToggleGroupsSuspended = false;
 	g_globalSuspensionStarted = {};
+	g_groupFullUpdatePending = true;
 }
 
-static void suspendAllToggleGroups()
+static void suspendAllToggleGroups(const std::chrono::steady_clock::time_point& now)
 {
 	if (g_allToggleGroupsSuspended)
 		return;
 
 	g_allToggleGroupsSuspended = true;
-	g_globalSuspensionStarted = std::chrono::steady_clock::now();
+	g_globalSuspensionStarted = now;
 	g_pendingSuspendedGroupToggles.clear();
 }
 
 static void toggleAllToggleGroupsSuspension()
 {
 	if (g_allToggleGroupsSuspended)
-		restoreAllToggleGroups();
+		restoreAllToggleGroups(g_frameClock.now);
 	else
-		suspendAllToggleGroups();
+		suspendAllToggleGroups(g_frameClock.now);
 }
 
 static bool isAnyGlobalHotkeyPressed(
 	const std::vector<KeyData>& hotkeys,
-	reshade::api::effect_runtime* runtime)
+	const KeyData::InputSnapshot& input)
 {
 	for (const auto& key : hotkeys)
 	{
-		if (key.isKeyPressed(runtime))
+		if (key.isKeyPressed(input))
 			return true;
 	}
 
 	return false;
 }
 
-static std::string buildIniSignature()
+// All keys any binding listens to, so the per-frame input snapshot only has to query those.
+static KeyData::InputKeyMask getGroupBindingKeys(const ToggleGroup& group)
 {
-	std::string data;
+	KeyData::InputKeyMask keys;
 
-	//
-	data += "Creator=";
-	data += GT_CREATOR;
-	data += "|AmountGroups=";
-	data += std::to_string(g_toggleGroups.size());
-	data += "|ControllerMode=";
-	data += std::to_string(static_cast<int>(KeyData::getControllerLabelMode()));
-	data += "|GlobalHotkeyModifier=";
-	data += std::to_string(KeyData::globalHotkeyModifierToInt(KeyData::getGlobalHotkeyModifier()));
-	data += "|GlobalSuspendHotkeyCount=";
-	data += std::to_string(g_globalSuspendHotkeys.size());
-	for (size_t i = 0; i < g_globalSuspendHotkeys.size(); ++i)
+	group.getToggleKey().addToInputKeyMask(keys);
+	for (size_t i = 0; i < group.getTimedTriggerKeyCount(); ++i)
+		group.getTimedTriggerBindingAt(i).key.addToInputKeyMask(keys);
+	for (size_t i = 0; i < group.getTimedSuppressionKeyCount(); ++i)
+		group.getTimedSuppressionKeyAt(i).addToInputKeyMask(keys);
+
+	return keys;
+}
+
+template <typename Callback>
+static void forEachKeyInMask(const KeyData::InputKeyMask& mask, Callback&& callback)
+{
+	for (int word = 0; word < 4; ++word)
 	{
-		data += "|GlobalSuspendHotkey" + std::to_string(i) + "=";
-		data += std::to_string(g_globalSuspendHotkeys[i].toInt());
+		uint64_t remaining = mask.bits[word];
+		while (remaining != 0)
+		{
+			callback(static_cast<uint8_t>(word * 64 + std::countr_zero(remaining)));
+			remaining &= remaining - 1;
+		}
 	}
+}
 
-	data += "|GlobalRestoreHotkeyCount=";
-	data += std::to_string(g_globalRestoreHotkeys.size());
-	for (size_t i = 0; i < g_globalRestoreHotkeys.size(); ++i)
+// Rebuilds the dispatch index and the hotkey interest mask if a group or the group list changed, or hunting
+// started or stopped, since the last build.
+static void updateHotkeyDispatchIndex()
+{
+	const bool hunting = isHuntingShaders();
+	if (!g_hotkeyDispatchDirty && g_hotkeyDispatchGroupRevision == ToggleGroup::getLatestRevision() && g_hotkeyDispatchHunting == hunting)
 	{
-		data += "|GlobalRestoreHotkey" + std::to_string(i) + "=";
-		data += std::to_string(g_globalRestoreHotkeys[i].toInt());
+		return;
 	}
 
-	//
-	data += "|SigA=";
-	data += GT_SIG_A;
-	data += "|SigB=";
-	data += GT_SIG_B;
-	data += "|SigC=";
-	data += GT_SIG_C;
-	data += "|SigD=";
-	data += GT_SIG_D;
-	data += "|SigSeed=";
-	data += toHex64(GT_SIG_SEED);
+	g_hotkeyDispatchDirty = false;
+	g_hotkeyDispatchGroupRevision = ToggleGroup::getLatestRevision();
+	g_hotkeyDispatchHunting = hunting;
+
+	KeyData::InputKeyMask& interest = g_hotkeyInterestMask;
+	interest = KeyData::InputKeyMask();
+
+	for (const auto& key : g_globalSuspendHotkeys)
+		key.addToInputKeyMask(interest);
+	for (const auto& key : g_globalRestoreHotkeys)
+		key.addToInputKeyMask(interest);
+	// the navigation keys are only sampled while hunting, so they don't cost a key poll every other frame.
+	if (hunting)
+	{
+		for (const auto& binding : g_huntingNavigationBindings)
+			interest.add(binding.keyCode);
+	}
 
+	// counting pass, then fill each code's range in slot order.
+	std::array<uint32_t, 256> counts = {};
 	for (const auto& group : g_toggleGroups)
 	{
-		data += "|Name=" + group.getName();
-		data += "|Notice=" + group.getNotice();
-		data += "|Key=" + std::to_string(group.getToggleKey().toInt());
-		data += "|Startup=" + std::to_string(group.isActiveAtStartup() ? 1 : 0);
-		data += "|StartupTimed=" + std::to_string(group.isStartupTimed() ? 1 : 0);
-		data += "|StartupDurationMs=" + std::to_string(group.getStartupDurationMs());
-		data += "|Hold=" + std::to_string(group.isHoldMode() ? 1 : 0);
-		data += "|HoldInverted=" + std::to_string(group.isHoldInverted() ? 1 : 0);
-		data += "|Timed=" + std::to_string(group.isTimedMode() ? 1 : 0);
-		data += "|TimedInverted=" + std::to_string(group.isTimedModeInverted() ? 1 : 0);
-		data += "|TimedDelay=" + std::to_string(group.getTimedModeDelayMs());
-		data += "|TimedMinVisible=" + std::to_string(group.getTimedModeMinVisibleMs());
-		data += "|TimedFadeOut=" + std::to_string(group.getTimedModeFadeOutMs());
-		data += "|TimedTriggerCount=" + std::to_string(group.getTimedTriggerKeyCount());
+		forEachKeyInMask(getGroupBindingKeys(group), [&counts](uint8_t code) { ++counts[code]; });
+	}
 
-		for (size_t i = 0; i < group.getTimedTriggerKeyCount(); ++i)
-		{
-			data += "|TimedTriggerKey" + std::to_string(i) + "=" + std::to_string(group.getTimedTriggerKeyAt(i).toInt());
-			data += "|TimedTriggerMode" + std::to_string(i) + "=" + std::to_string(ToggleGroup::timedTriggerModeToInt(group.getTimedTriggerModeAt(i)));
-		}
+	g_hotkeyDispatchOffsets[0] = 0;
+	for (size_t code = 0; code < counts.size(); ++code)
+	{
+		g_hotkeyDispatchOffsets[code + 1] = g_hotkeyDispatchOffsets[code] + counts[code];
+	}
 
-		data += "|TimedSuppressionCount=" + std::to_string(group.getTimedSuppressionKeyCount());
-		data += "|TimedSuppressionLinger=" + std::to_string(group.getTimedSuppressionLingerMs());
-		for (size_t i = 0; i < group.getTimedSuppressionKeyCount(); ++i)
-		{
-			data += "|TimedSuppressionKey" + std::to_string(i) + "=" + std::to_string(group.getTimedSuppressionKeyAt(i).toInt());
-		}
+	g_hotkeyDispatchSlots.resize(g_hotkeyDispatchOffsets[256]);
+	std::array<uint32_t, 256> fillPositions;
+	std::copy(g_hotkeyDispatchOffsets.begin(), g_hotkeyDispatchOffsets.end() - 1, fillPositions.begin());
+
+	for (uint32_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+	{
+		const KeyData::InputKeyMask groupKeys = getGroupBindingKeys(g_toggleGroups[slot]);
+		forEachKeyInMask(groupKeys, [&fillPositions, slot](uint8_t code) { g_hotkeyDispatchSlots[fillPositions[code]++] = slot; });
+
+		for (int word = 0; word < 4; ++word)
+			interest.bits[word] |= groupKeys.bits[word];
+	}
+}
 
-		appendSortedHashesToSignature(data, "P", group.getPixelShaderHashes());
-		appendSortedHashesToSignature(data, "V", group.getVertexShaderHashes());
-		appendSortedHashesToSignature(data, "C", group.getComputeShaderHashes());
+static void queueGroupUpdate(uint32_t slot)
+{
+	GroupRuntimeState& state = g_groupRuntimeStates[slot];
+	if (state.updateQueued)
+	{
+		return;
 	}
 
-	return toHex64(fnv1a64(data));
+	state.updateQueued = true;
+	g_groupUpdateSlots.push_back(slot);
 }
 
-static bool fileContainsTopAndBottomWatermark(const std::filesystem::path& filename)
+static void addSortedHashesToSignature(Fnv1a64Stream& hash, const char* prefix, const std::unordered_set<uint32_t>& hashes)
 {
-	std::ifstream inFile(filename, std::ios::binary);
-	if (!inFile.is_open())
-		return false;
+	std::vector<uint32_t> sorted(hashes.begin(), hashes.end());
+	std::sort(sorted.begin(), sorted.end());
 
-	std::string content((std::istreambuf_iterator<char>(inFile)),
-	                    std::istreambuf_iterator<char>());
-	inFile.close();
+	for (const auto value : sorted)
+		hash.addField(prefix, value);
+}
 
-	const bool hasHeader = content.rfind(GT_HEADER, 0) == 0;
-	const bool hasFooter = content.find(GT_FOOTER) != std::string::npos;
+static uint64_t buildGroupSignature(const ToggleGroup& group)
+{
+	Fnv1a64Stream hash;
+	hash.add("|Name=");
+	hash.add(group.getName());
+	hash.add("|Notice=");
+	hash.add(group.getNotice());
+	hash.addField("Key", group.getToggleKey().toInt());
+	hash.addField("Startup", group.isActiveAtStartup() ? 1 : 0);
+	hash.addField("StartupTimed", group.isStartupTimed() ? 1 : 0);
+	hash.addField("StartupDurationMs", group.getStartupDurationMs());
+	hash.addField("Hold", group.isHoldMode() ? 1 : 0);
+	hash.addField("HoldInverted", group.isHoldInverted() ? 1 : 0);
+	hash.addField("Timed", group.isTimedMode() ? 1 : 0);
+	hash.addField("TimedInverted", group.isTimedModeInverted() ? 1 : 0);
+	hash.addField("TimedDelay", group.getTimedModeDelayMs());
+	hash.addField("TimedMinVisible", group.getTimedModeMinVisibleMs());
+	hash.addField("TimedFadeOut", group.getTimedModeFadeOutMs());
+	hash.addField("TimedTriggerCount", group.getTimedTriggerKeyCount());
+
+	for (size_t i = 0; i < group.getTimedTriggerKeyCount(); ++i)
+	{
+		hash.addField("TimedTriggerKey", group.getTimedTriggerKeyAt(i).toInt(), static_cast<int>(i));
+		hash.addField("TimedTriggerMode", ToggleGroup::timedTriggerModeToInt(group.getTimedTriggerModeAt(i)), static_cast<int>(i));
+	}
 
-	return hasHeader && hasFooter;
+	hash.addField("TimedSuppressionCount", group.getTimedSuppressionKeyCount());
+	hash.addField("TimedSuppressionLinger", group.getTimedSuppressionLingerMs());
+	for (size_t i = 0; i < group.getTimedSuppressionKeyCount(); ++i)
+	{
+		hash.addField("TimedSuppressionKey", group.getTimedSuppressionKeyAt(i).toInt(), static_cast<int>(i));
+	}
+
+	addSortedHashesToSignature(hash, "P", group.getPixelShaderHashes());
+	addSortedHashesToSignature(hash, "V", group.getVertexShaderHashes());
+	addSortedHashesToSignature(hash, "C", group.getComputeShaderHashes());
+	return hash.state;
 }
 
-static void rewriteIniWithTopAndBottomWatermark(const std::filesystem::path& filename)
+// Returns the group's digest, recomputing it only when the group's revision has changed since the last signature.
+static uint64_t getCachedGroupSignature(const ToggleGroup& group)
 {
-	std::ifstream inFile(filename, std::ios::binary);
-	if (!inFile.is_open())
-		return;
+	GroupSignatureCacheEntry& entry = g_groupSignatureCache[group.getId()];
+	if (!entry.valid || entry.revision != group.getRevision())
+	{
+		entry.digest = buildGroupSignature(group);
+		entry.revision = group.getRevision();
+		entry.valid = true;
+	}
+	entry.generation = g_groupSignatureGeneration;
+	return entry.digest;
+}
 
-	std::string content((std::istreambuf_iterator<char>(inFile)),
-	                    std::istreambuf_iterator<char>());
-	inFile.close();
+static std::string buildIniSignature()
+{
+	Fnv1a64Stream hash;
+	++g_groupSignatureGeneration;
 
-	if (content.rfind(GT_HEADER, 0) == 0)
+	//
+	hash.add("Creator=");
+	hash.add(GT_CREATOR);
+	hash.addField("AmountGroups", g_toggleGroups.size());
+	hash.addField("ControllerMode", static_cast<int>(KeyData::getControllerLabelMode()));
+	hash.addField("GlobalHotkeyModifier", KeyData::globalHotkeyModifierToInt(KeyData::getGlobalHotkeyModifier()));
+	hash.addField("GlobalSuspendHotkeyCount", g_globalSuspendHotkeys.size());
+	for (size_t i = 0; i < g_globalSuspendHotkeys.size(); ++i)
 	{
-		content.erase(0, std::strlen(GT_HEADER));
+		hash.addField("GlobalSuspendHotkey", g_globalSuspendHotkeys[i].toInt(), static_cast<int>(i));
 	}
 
-	size_t footerPos = content.find(GT_FOOTER);
-	if (footerPos != std::string::npos)
+	hash.addField("GlobalRestoreHotkeyCount", g_globalRestoreHotkeys.size());
+	for (size_t i = 0; i < g_globalRestoreHotkeys.size(); ++i)
 	{
-		content.erase(footerPos, std::strlen(GT_FOOTER));
+		hash.addField("GlobalRestoreHotkey", g_globalRestoreHotkeys[i].toInt(), static_cast<int>(i));
 	}
 
-	std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
-	if (!outFile.is_open())
-		return;
+	//
+	hash.add("|SigA=");
+	hash.add(GT_SIG_A);
+	hash.add("|SigB=");
+	hash.add(GT_SIG_B);
+	hash.add("|SigC=");
+	hash.add(GT_SIG_C);
+	hash.add("|SigD=");
+	hash.add(GT_SIG_D);
+	hash.add("|SigSeed=");
+	hash.add(toHex64(GT_SIG_SEED));
+
+	for (const auto& group : g_toggleGroups)
+	{
+		const uint64_t digest = getCachedGroupSignature(group);
+		hash.add(reinterpret_cast<const char*>(&digest), sizeof(digest));
+	}
+
+	std::erase_if(g_groupSignatureCache, [](const auto& item) { return item.second.generation != g_groupSignatureGeneration; });
+
+	return toHex64(hash.state);
+}
+
+static bool fileContainsTopAndBottomWatermark(const std::filesystem::path& filename)
+{
+	std::ifstream inFile(filename, std::ios::binary);
+	if (!inFile.is_open())
+		return false;
+
+	std::string content((std::istreambuf_iterator<char>(inFile)),
+	                    std::istreambuf_iterator<char>());
+	inFile.close();
+
+	const bool hasHeader = content.rfind(GT_HEADER, 0) == 0;
+	const bool hasFooter = content.find(GT_FOOTER) != std::string::npos;
 
-	outFile << GT_HEADER << content << GT_FOOTER;
-	outFile.close();
+	return hasHeader && hasFooter;
 }
 
 static uint32_t calculateShaderHash(void* shaderData)
@@ -654,16 +1090,45 @@ void addDefaultGroup()
 	g_toggleGroups.push_back(toAdd);
 }
 
-void loadShaderTogglerIniFile()
+static void setHuntCandidateFilter(HuntCandidateFilter filter)
 {
-	CDataFile iniFile;
-	if (!iniFile.Load(g_iniFileName))
+	g_huntCandidateFilter = filter;
+
+	std::lock_guard lock(g_deviceRegistryMutex);
+	for (DeviceDataContainer* deviceData : g_deviceRegistry)
 	{
-		return;
+		deviceData->pixelShaderManager.setHuntCandidateFilter(filter);
+		deviceData->vertexShaderManager.setHuntCandidateFilter(filter);
+		deviceData->computeShaderManager.setHuntCandidateFilter(filter);
+	}
+}
+
+static IniFileStamp readIniFileStamp()
+{
+	IniFileStamp stamp;
+	std::error_code error;
+	stamp.writeTime = std::filesystem::last_write_time(g_iniFileName, error);
+	if (error)
+	{
+		return stamp;
 	}
 
+	stamp.size = std::filesystem::file_size(g_iniFileName, error);
+	stamp.exists = !error;
+	return stamp;
+}
+
+// The live state now matches the file on disk, including the add-on's own writes so far.
+static void rememberIniFileStamp()
+{
+	g_iniFileStampWrites = g_configPersistence.getStats().writes;
+	g_iniFileStamp = readIniFileStamp();
+}
+
+static int getIniGroupCount(CDataFile& iniFile, bool& usingCustomFormat)
+{
 	int numberOfGroups = iniFile.GetInt("GTAmountGroups", "General");
-	bool usingCustomFormat = true;
+	usingCustomFormat = true;
 
 	if (numberOfGroups == INT_MIN)
 	{
@@ -671,6 +1136,33 @@ void loadShaderTogglerIniFile()
 		usingCustomFormat = false;
 	}
 
+	return numberOfGroups;
+}
+
+static int getIniGroupHashFormat(CDataFile& iniFile)
+{
+	const int savedGroupHashFormat = iniFile.GetInt("GTGroupFormat", "General");
+	return savedGroupHashFormat == INT_MIN ? ToggleGroup::LegacyHashFormat : savedGroupHashFormat;
+}
+
+static std::vector<ToggleGroup> loadToggleGroups(CDataFile& iniFile, int numberOfGroups, bool usingCustomFormat)
+{
+	const int groupHashFormat = getIniGroupHashFormat(iniFile);
+
+	std::vector<ToggleGroup> groups;
+	groups.reserve(numberOfGroups > 0 ? static_cast<size_t>(numberOfGroups) : 0);
+	for (int i = 0; i < numberOfGroups; i++)
+	{
+		groups.push_back(ToggleGroup("", ToggleGroup::getNewGroupId()));
+		groups.back().loadState(iniFile, i, usingCustomFormat, groupHashFormat);
+	}
+
+	return groups;
+}
+
+// Everything in [General] except the group count: controller labels, hunting keys, polling and global hotkeys.
+static void loadGeneralSettings(CDataFile& iniFile)
+{
 	const int savedControllerMode = iniFile.GetInt("ControllerLabelMode", "General");
 	if (savedControllerMode >= static_cast<int>(KeyData::ControllerLabelMode::Auto) &&
 		savedControllerMode <= static_cast<int>(KeyData::ControllerLabelMode::PlayStation))
@@ -692,19 +1184,64 @@ void loadShaderTogglerIniFile()
 		KeyData::setGlobalHotkeyModifier(KeyData::GlobalHotkeyModifier::None);
 	}
 
-	g_globalSuspendHotkeys.clear();
-	g_globalRestoreHotkeys.clear();
+	g_backgroundSamplingEnabled = iniFile.GetBool("BackgroundShaderSampling", "General");
+	g_configCacheEnabled = iniFile.GetValue("BinaryConfigCache", "General").empty() || iniFile.GetBool("BinaryConfigCache", "General");
 
-	const std::vector<uint32_t> savedGlobalSuspendHotkeys =
-		iniFile.GetArray("GlobalSuspendHotkeys", "General");
-	for (const uint32_t keyValue : savedGlobalSuspendHotkeys)
+	// Hunting keys: one virtual key code per navigation entry, in the order of g_huntingNavigationBindings.
+	const std::vector<uint32_t> savedHuntingKeys = iniFile.GetArray("HuntingKeys", "General");
+	for (int i = 0; i < g_huntingNavigationKeyCount; ++i)
 	{
-		KeyData key = KeyData::fromInt(keyValue);
-		if (key.isValid() && !globalHotkeyExists(g_globalSuspendHotkeys, key))
-			g_globalSuspendHotkeys.push_back(key);
+		uint32_t keyCode = VK_NUMPAD1 + i;
+		if (savedHuntingKeys.size() == g_huntingNavigationKeyCount && savedHuntingKeys[i] > 0 && savedHuntingKeys[i] < 0xF0)
+		{
+			keyCode = savedHuntingKeys[i];
+		}
+		setHuntingNavigationKey(i, static_cast<uint8_t>(keyCode));
 	}
 
-	const std::vector<uint32_t> savedGlobalRestoreHotkeys =
+	// Repeat curve: three held-for thresholds (ascending), then the four repeat intervals.
+	g_huntingRepeatCurve = HoldRepeatCurve();
+	const std::vector<uint32_t> savedRepeatCurve = iniFile.GetArray("HuntingRepeatCurve", "General");
+	if (savedRepeatCurve.size() == 7 &&
+		savedRepeatCurve[0] <= savedRepeatCurve[1] && savedRepeatCurve[1] <= savedRepeatCurve[2] &&
+		std::all_of(savedRepeatCurve.begin() + 3, savedRepeatCurve.end(), [](uint32_t intervalMs) { return intervalMs > 0 && intervalMs <= 2000; }))
+	{
+		std::copy(savedRepeatCurve.begin(), savedRepeatCurve.begin() + 3, g_huntingRepeatCurve.heldMs);
+		std::copy(savedRepeatCurve.begin() + 3, savedRepeatCurve.end(), g_huntingRepeatCurve.intervalMs);
+	}
+	g_hotkeyDispatchDirty = true;
+
+	int savedGamepadPollingInterval = iniFile.GetInt("GamepadPollingIntervalMs", "General");
+	if (savedGamepadPollingInterval < 1 || savedGamepadPollingInterval > GAMEPAD_POLLING_INTERVAL_MS_MAX)
+	{
+		savedGamepadPollingInterval = GAMEPAD_POLLING_INTERVAL_MS_DEFAULT;
+	}
+	KeyData::setGamepadPollingThread(iniFile.GetBool("GamepadPollingThread", "General"), static_cast<uint32_t>(savedGamepadPollingInterval));
+
+	const int savedHuntCandidateFilter = iniFile.GetInt("HuntCandidateFilter", "General");
+	if (savedHuntCandidateFilter >= static_cast<int>(HuntCandidateFilter::All) &&
+		savedHuntCandidateFilter <= static_cast<int>(HuntCandidateFilter::DepthOnly))
+	{
+		setHuntCandidateFilter(static_cast<HuntCandidateFilter>(savedHuntCandidateFilter));
+	}
+	else
+	{
+		setHuntCandidateFilter(HuntCandidateFilter::All);
+	}
+
+	g_globalSuspendHotkeys.clear();
+	g_globalRestoreHotkeys.clear();
+
+	const std::vector<uint32_t> savedGlobalSuspendHotkeys =
+		iniFile.GetArray("GlobalSuspendHotkeys", "General");
+	for (const uint32_t keyValue : savedGlobalSuspendHotkeys)
+	{
+		KeyData key = KeyData::fromInt(keyValue);
+		if (key.isValid() && !globalHotkeyExists(g_globalSuspendHotkeys, key))
+			g_globalSuspendHotkeys.push_back(key);
+	}
+
+	const std::vector<uint32_t> savedGlobalRestoreHotkeys =
 		iniFile.GetArray("GlobalRestoreHotkeys", "General");
 	for (const uint32_t keyValue : savedGlobalRestoreHotkeys)
 	{
@@ -731,27 +1268,176 @@ void loadShaderTogglerIniFile()
 		}
 	}
 
+	g_hotkeyDispatchDirty = true;
+}
+
+// The [General] values as strings, then the groups. contentStamp is the INI's CacheStamp for the same state.
+static void writeConfigCacheGeneralSettings(ConfigCacheWriter& writer, CDataFile& iniFile, const std::string& contentStamp)
+{
+	writer.writeString(contentStamp);
+
+	const KeyList* generalKeys = iniFile.GetSectionKeys("General");
+	writer.writeUInt(generalKeys == nullptr ? 0 : static_cast<uint32_t>(generalKeys->size()));
+	if (generalKeys != nullptr)
+	{
+		for (const t_Key& key : *generalKeys)
+		{
+			writer.writeString(key.szKey);
+			writer.writeString(key.szValue);
+		}
+	}
+}
+
+// For an INI the live groups were just loaded from.
+static std::vector<uint8_t> buildConfigCachePayload(CDataFile& iniFile, const std::string& contentStamp)
+{
+	ConfigCacheWriter writer;
+	writeConfigCacheGeneralSettings(writer, iniFile, contentStamp);
+
+	writer.writeUInt(static_cast<uint32_t>(g_toggleGroups.size()));
+	for (const auto& group : g_toggleGroups)
+	{
+		group.saveCacheState(writer);
+	}
+
+	return std::move(writer.getBuffer());
+}
+
+// Runs on the persistence worker once a save is written, so the render thread only builds the INI. The groups
+// are read back from the snapshot into a scratch group, which takes no group id.
+static std::vector<uint8_t> buildConfigCachePayloadFromSnapshot(CDataFile& snapshot, const std::string& contentStamp)
+{
+	ConfigCacheWriter writer;
+	writeConfigCacheGeneralSettings(writer, snapshot, contentStamp);
+
+	bool usingCustomFormat = true;
+	const int numberOfGroups = std::max(getIniGroupCount(snapshot, usingCustomFormat), 0);
+	const int groupHashFormat = getIniGroupHashFormat(snapshot);
+
+	writer.writeUInt(static_cast<uint32_t>(numberOfGroups));
+	ToggleGroup group("", 0);
+	for (int i = 0; i < numberOfGroups; i++)
+	{
+		group.loadState(snapshot, i, usingCustomFormat, groupHashFormat);
+		group.saveCacheState(writer);
+	}
+
+	return std::move(writer.getBuffer());
+}
+
+// Loads settings and groups from the binary cache. Returns false if there is no cache for the INI as it is on
+// disk or it doesn't check out; the caller then loads the INI, which overrides anything applied here.
+static bool loadShaderTogglerConfigCache()
+{
+	std::vector<uint8_t> payload;
+	if (!ConfigCache::read(g_iniFileName, payload))
+	{
+		return false;
+	}
+
+	ConfigCacheReader reader(payload.data(), payload.size());
+	const std::string contentStamp = reader.readString();
+
+	CDataFile generalSettings;
+	const uint32_t generalKeyCount = reader.readUInt();
+	for (uint32_t i = 0; i < generalKeyCount && !reader.failed(); ++i)
+	{
+		const std::string key = reader.readString();
+		const std::string value = reader.readString();
+		generalSettings.SetValue(key, value, "", "General");
+	}
+
+	std::vector<ToggleGroup> groups;
+	const uint32_t groupCount = reader.readUInt();
+	for (uint32_t i = 0; i < groupCount && !reader.failed(); ++i)
+	{
+		groups.push_back(ToggleGroup("", ToggleGroup::getNewGroupId()));
+		groups.back().loadCacheState(reader);
+	}
+
+	const bool complete = !reader.failed() && reader.atEnd();
+	if (complete)
+	{
+		loadGeneralSettings(generalSettings);
+		g_toggleGroups = std::move(groups);
+	}
+
+	// only an in-memory model; clearing it keeps its destructor from saving it.
+	generalSettings.Clear();
+
+	// the stamp also catches a cache that matches the INI's size and write time but not its contents.
+	return complete && buildIniSignature() == contentStamp;
+}
+
+static void writeShaderTogglerConfigCache(CDataFile& iniFile)
+{
+	if (g_configCacheEnabled)
+	{
+		ConfigCache::write(g_iniFileName, buildConfigCachePayload(iniFile, buildIniSignature()));
+	}
+}
+
+static void startLoadedToggleGroups()
+{
+	g_groupRuntimeStates.clear();
+	syncGroupRuntimeStates();
+	const auto startupNow = std::chrono::steady_clock::now();
+	for (size_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+	{
+		const ToggleGroup& group = g_toggleGroups[slot];
+		if (group.isActiveAtStartup() && group.isStartupTimed())
+			g_groupRuntimeStates[slot].startupActivationStartTime = startupNow;
+	}
+
+	rememberIniFileStamp();
+}
+
+void loadShaderTogglerIniFile()
+{
+	// a save still waiting for its debounce window would otherwise be read back stale and then overwrite this load.
+	g_configPersistence.flush();
+
+	g_configLoadedFromCache = loadShaderTogglerConfigCache();
+	if (g_configLoadedFromCache)
+	{
+		g_allToggleGroupsSuspended = false;
+		g_pendingSuspendedGroupToggles.clear();
+		g_globalSuspensionStarted = {};
+		startLoadedToggleGroups();
+		return;
+	}
+
+	CDataFile iniFile;
+	if (!iniFile.Load(g_iniFileName))
+	{
+		return;
+	}
+
+	bool usingCustomFormat = true;
+	const int numberOfGroups = getIniGroupCount(iniFile, usingCustomFormat);
+
+	loadGeneralSettings(iniFile);
+
 	g_allToggleGroupsSuspended = false;
 	g_pendingSuspendedGroupToggles.clear();
 	g_globalSuspensionStarted = {};
+	g_hotkeyDispatchDirty = true;
 
 	if (numberOfGroups == INT_MIN)
 	{
 		addDefaultGroup();
 		g_toggleGroups[0].loadState(iniFile, -1, false);
 		saveShaderTogglerIniFile();
-		g_groupStartupActivationStartTime.clear();
+		g_groupRuntimeStates.clear();
+		syncGroupRuntimeStates();
 		if (g_toggleGroups[0].isActiveAtStartup() && g_toggleGroups[0].isStartupTimed())
-			g_groupStartupActivationStartTime[g_toggleGroups[0].getId()] = std::chrono::steady_clock::now();
+			g_groupRuntimeStates[0].startupActivationStartTime = std::chrono::steady_clock::now();
+		rememberIniFileStamp();
+		iniFile.Clear();
 		return;
 	}
 
-	g_toggleGroups.clear();
-	for (int i = 0; i < numberOfGroups; i++)
-	{
-		g_toggleGroups.push_back(ToggleGroup("", ToggleGroup::getNewGroupId()));
-		g_toggleGroups.back().loadState(iniFile, i, usingCustomFormat);
-	}
+	g_toggleGroups = loadToggleGroups(iniFile, numberOfGroups, usingCustomFormat);
 
 	if (usingCustomFormat)
 	{
@@ -772,55 +1458,427 @@ void loadShaderTogglerIniFile()
 
 		if (needsRepair)
 		{
+			// the save writes the cache as well.
 			saveShaderTogglerIniFile();
 		}
+		else
+		{
+			writeShaderTogglerConfigCache(iniFile);
+		}
 	}
-
-	g_groupStartupActivationStartTime.clear();
-	const auto startupNow = std::chrono::steady_clock::now();
-	for (const auto& group : g_toggleGroups)
+	else
 	{
-		if (group.isActiveAtStartup() && group.isStartupTimed())
-			g_groupStartupActivationStartTime[group.getId()] = startupNow;
+		writeShaderTogglerConfigCache(iniFile);
 	}
+
+	// only read; clearing it keeps its destructor from saving it.
+	iniFile.Clear();
+	startLoadedToggleGroups();
 }
 
 void saveShaderTogglerIniFile()
 {
-	CDataFile iniFile;
-
-	iniFile.SetInt("GTAmountGroups", static_cast<int>(g_toggleGroups.size()), "", "General");
-	iniFile.SetValue("Creator", GT_CREATOR, "", "General");
-	iniFile.SetValue(GT_CACHE_KEY, buildIniSignature(), "", "General");
-	iniFile.SetInt("ControllerLabelMode", static_cast<int>(KeyData::getControllerLabelMode()), "", "General");
-	iniFile.SetInt("GlobalHotkeyModifier", KeyData::globalHotkeyModifierToInt(KeyData::getGlobalHotkeyModifier()), "", "General");
+	auto iniFile = std::make_unique<CDataFile>();
+
+	iniFile->SetInt("GTAmountGroups", static_cast<int>(g_toggleGroups.size()), "", "General");
+	iniFile->SetInt("GTGroupFormat", ToggleGroup::PackedHashFormat, "", "General");
+	iniFile->SetValue("Creator", GT_CREATOR, "", "General");
+	const std::string contentStamp = buildIniSignature();
+	iniFile->SetValue(GT_CACHE_KEY, contentStamp, "", "General");
+	iniFile->SetInt("ControllerLabelMode", static_cast<int>(KeyData::getControllerLabelMode()), "", "General");
+	iniFile->SetInt("GlobalHotkeyModifier", KeyData::globalHotkeyModifierToInt(KeyData::getGlobalHotkeyModifier()), "", "General");
+	iniFile->SetBool("BackgroundShaderSampling", g_backgroundSamplingEnabled, "", "General");
+	iniFile->SetBool("BinaryConfigCache", g_configCacheEnabled, "", "General");
+
+	std::vector<uint32_t> huntingKeyValues;
+	for (const auto& binding : g_huntingNavigationBindings)
+		huntingKeyValues.push_back(binding.keyCode);
+	iniFile->SetArray("HuntingKeys", huntingKeyValues, "", "General");
+
+	std::vector<uint32_t> huntingRepeatCurveValues(std::begin(g_huntingRepeatCurve.heldMs), std::end(g_huntingRepeatCurve.heldMs));
+	huntingRepeatCurveValues.insert(huntingRepeatCurveValues.end(), std::begin(g_huntingRepeatCurve.intervalMs), std::end(g_huntingRepeatCurve.intervalMs));
+	iniFile->SetArray("HuntingRepeatCurve", huntingRepeatCurveValues, "", "General");
+	iniFile->SetBool("GamepadPollingThread", KeyData::isGamepadPollingThreadEnabled(), "", "General");
+	iniFile->SetInt("GamepadPollingIntervalMs", static_cast<int>(KeyData::getGamepadPollingIntervalMs()), "", "General");
+	iniFile->SetInt("HuntCandidateFilter", static_cast<int>(g_huntCandidateFilter), "", "General");
 
 	std::vector<uint32_t> globalSuspendHotkeyValues;
 	globalSuspendHotkeyValues.reserve(g_globalSuspendHotkeys.size());
 	for (const auto& key : g_globalSuspendHotkeys)
 		globalSuspendHotkeyValues.push_back(static_cast<uint32_t>(key.toInt()));
-	iniFile.SetArray("GlobalSuspendHotkeys", globalSuspendHotkeyValues, "", "General");
+	iniFile->SetArray("GlobalSuspendHotkeys", globalSuspendHotkeyValues, "", "General");
 
 	std::vector<uint32_t> globalRestoreHotkeyValues;
 	globalRestoreHotkeyValues.reserve(g_globalRestoreHotkeys.size());
 	for (const auto& key : g_globalRestoreHotkeys)
 		globalRestoreHotkeyValues.push_back(static_cast<uint32_t>(key.toInt()));
-	iniFile.SetArray("GlobalRestoreHotkeys", globalRestoreHotkeyValues, "", "General");
+	iniFile->SetArray("GlobalRestoreHotkeys", globalRestoreHotkeyValues, "", "General");
 
 	for (int i = 0; i < static_cast<int>(g_toggleGroups.size()); i++)
 	{
-		g_toggleGroups[i].saveState(iniFile, i, true);
+		g_toggleGroups[i].saveState(*iniFile, i, true);
+	}
+
+	iniFile->SetFileName(g_iniFileName);
+	iniFile->SetHeader(GT_HEADER);
+	iniFile->SetFooter(GT_FOOTER);
+
+	// the cache is stamped with the INI's size and write time, so it is written once the INI is on disk.
+	ConfigPersistenceWorker::WrittenCallback onWritten;
+	if (g_configCacheEnabled)
+	{
+		onWritten = [contentStamp, fileName = g_iniFileName](CDataFile& snapshot, bool saved)
+			{
+				if (saved)
+					ConfigCache::write(fileName, buildConfigCachePayloadFromSnapshot(snapshot, contentStamp));
+			};
+	}
+
+	// the model is a snapshot of the current state; the worker coalesces bursts of saves and writes the newest.
+	g_configPersistence.submit(std::move(iniFile), std::move(onWritten));
+}
+
+static bool isAnyConfigEditorOpen()
+{
+	return g_toggleGroupIdKeyBindingEditing >= 0 ||
+		g_toggleGroupIdTimedTriggerKeyEditing >= 0 ||
+		g_toggleGroupIdTimedSuppressionKeyEditing >= 0 ||
+		g_toggleGroupIdShaderEditing >= 0 ||
+		g_globalSuspendHotkeySlotEditing >= 0 ||
+		g_globalRestoreHotkeySlotEditing >= 0;
+}
+
+// Swaps in the groups of a changed INI. A loaded group whose settings and hashes equal a live group's is not
+// swapped: the live group keeps its id, active state and runtime state. Changed and new groups start as on a load.
+static void applyReloadedIniFile(CDataFile& iniFile, const std::chrono::steady_clock::time_point& now)
+{
+	bool usingCustomFormat = true;
+	const int numberOfGroups = getIniGroupCount(iniFile, usingCustomFormat);
+	if (numberOfGroups == INT_MIN || numberOfGroups < 0)
+	{
+		reshade::log_message(2, "ShaderToggler: changed ShaderToggler.ini has no group count, reload ignored.");
+		return;
+	}
+
+	loadGeneralSettings(iniFile);
+
+	std::vector<ToggleGroup> loadedGroups = loadToggleGroups(iniFile, numberOfGroups, usingCustomFormat);
+	std::vector<ToggleGroup> mergedGroups;
+	mergedGroups.reserve(loadedGroups.size());
+	std::vector<bool> liveGroupKept(g_toggleGroups.size(), false);
+	std::unordered_set<int> swappedGroupIds;
+
+	for (auto& loadedGroup : loadedGroups)
+	{
+		const uint64_t loadedSignature = buildGroupSignature(loadedGroup);
+		size_t liveSlot = 0;
+		while (liveSlot < g_toggleGroups.size() &&
+			(liveGroupKept[liveSlot] || getCachedGroupSignature(g_toggleGroups[liveSlot]) != loadedSignature))
+		{
+			++liveSlot;
+		}
+
+		if (liveSlot < g_toggleGroups.size())
+		{
+			liveGroupKept[liveSlot] = true;
+			mergedGroups.push_back(g_toggleGroups[liveSlot]);
+		}
+		else
+		{
+			swappedGroupIds.insert(loadedGroup.getId());
+			mergedGroups.push_back(std::move(loadedGroup));
+		}
+	}
+
+	bool sameOrder = mergedGroups.size() == g_toggleGroups.size();
+	for (size_t slot = 0; sameOrder && slot < mergedGroups.size(); ++slot)
+	{
+		sameOrder = mergedGroups[slot].getId() == g_toggleGroups[slot].getId();
+	}
+
+	if (sameOrder)
+	{
+		return;
+	}
+
+	g_toggleGroups = std::move(mergedGroups);
+	syncGroupRuntimeStates();
+	for (size_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+	{
+		const ToggleGroup& group = g_toggleGroups[slot];
+		if (swappedGroupIds.count(group.getId()) != 0 && group.isActiveAtStartup() && group.isStartupTimed())
+			g_groupRuntimeStates[slot].startupActivationStartTime = now;
+	}
+
+	char message[160];
+	snprintf(message, sizeof(message), "ShaderToggler: reloaded ShaderToggler.ini, %zu of %zu group(s) changed.",
+		swappedGroupIds.size(), g_toggleGroups.size());
+	reshade::log_message(3, message);
+}
+
+// Called from present. Polls the INI at a low rate, starts a background parse when it changed on disk and
+// applies a finished parse; the apply happens before this frame's epoch starts so cached draw verdicts drop once.
+static void pollIniFileReload(const std::chrono::steady_clock::time_point& now)
+{
+	if (g_iniReloadParse.valid())
+	{
+		if (g_iniReloadParse.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return;
+		}
+
+		std::unique_ptr<CDataFile> iniFile = g_iniReloadParse.get();
+		if (iniFile == nullptr)
+		{
+			return;
+		}
+
+		if (isAnyConfigEditorOpen() || g_configPersistence.hasPendingSnapshot())
+		{
+			// an edit in progress wins; look at the file again on the next poll.
+			g_iniFileStamp = IniFileStamp();
+			return;
+		}
+
+		applyReloadedIniFile(*iniFile, now);
+		return;
+	}
+
+	if (now - g_iniFileLastPoll < std::chrono::milliseconds(CONFIG_RELOAD_POLL_INTERVAL_MS))
+	{
+		return;
+	}
+	g_iniFileLastPoll = now;
+
+	// a save still waiting would overwrite the file anyway.
+	if (g_configPersistence.hasPendingSnapshot())
+	{
+		return;
+	}
+
+	// the stamp before the write counts: a write that touched the file before the stamp was read has at least
+	// started by the time the counts are read.
+	const IniFileStamp stamp = readIniFileStamp();
+	const ConfigPersistenceWorker::Stats saveStats = g_configPersistence.getStats();
+	if (saveStats.writesStarted != saveStats.writes)
+	{
+		return;
+	}
+
+	if (saveStats.writes != g_iniFileStampWrites)
+	{
+		// the stamp may predate that write.
+		g_iniFileStampWrites = saveStats.writes;
+		g_iniFileStamp = readIniFileStamp();
+		return;
+	}
+
+	if (!stamp.exists || stamp == g_iniFileStamp || isAnyConfigEditorOpen())
+	{
+		return;
+	}
+
+	g_iniFileStamp = stamp;
+	const std::filesystem::path fileName = g_iniFileName;
+	g_iniReloadParse = std::async(std::launch::async, [fileName]()
+		{
+			auto iniFile = std::make_unique<CDataFile>();
+			if (!iniFile->Load(fileName))
+				return std::unique_ptr<CDataFile>();
+			return iniFile;
+		});
+}
+
+static HashPack buildHashPackFromToggleGroups()
+{
+	HashPack pack;
+	pack.groups.reserve(g_toggleGroups.size());
+	for (const auto& group : g_toggleGroups)
+	{
+		HashPackGroup& packGroup = pack.groups.emplace_back();
+		packGroup.name = group.getName();
+		packGroup.pixelShaderHashes.assign(group.getPixelShaderHashes().begin(), group.getPixelShaderHashes().end());
+		packGroup.vertexShaderHashes.assign(group.getVertexShaderHashes().begin(), group.getVertexShaderHashes().end());
+		packGroup.computeShaderHashes.assign(group.getComputeShaderHashes().begin(), group.getComputeShaderHashes().end());
+		std::sort(packGroup.pixelShaderHashes.begin(), packGroup.pixelShaderHashes.end());
+		std::sort(packGroup.vertexShaderHashes.begin(), packGroup.vertexShaderHashes.end());
+		std::sort(packGroup.computeShaderHashes.begin(), packGroup.computeShaderHashes.end());
+	}
+
+	return pack;
+}
+
+// Merges the groups of a pack file into the live groups. Only groups the merge changed get new hashes; added
+// groups get the default toggle key. A relative path is taken from the add-on's folder.
+static bool importHashPack(std::filesystem::path fileName, HashPackMergeMode mode, HashPackMergeReport& report)
+{
+	if (fileName.is_relative())
+	{
+		fileName = g_iniFileName.parent_path() / fileName;
+	}
+
+	CDataFile packFile;
+	HashPack source;
+	const bool loaded = packFile.Load(fileName) && HashPackMerge::read(packFile, source);
+	// only read; clearing it keeps its destructor from saving it.
+	packFile.Clear();
+	if (!loaded)
+	{
+		return false;
+	}
+
+	HashPack merged = buildHashPackFromToggleGroups();
+	report = HashPackMerge::merge(merged, source, mode);
+
+	for (size_t i = 0; i < merged.groups.size(); ++i)
+	{
+		const HashPackGroup& mergedGroup = merged.groups[i];
+		if (!mergedGroup.changed)
+		{
+			continue;
+		}
+
+		// the merge appends the groups it adds, in order, after the existing ones.
+		if (i >= g_toggleGroups.size())
+		{
+			addDefaultGroup();
+			g_toggleGroups.back().setName(mergedGroup.name);
+		}
+
+		g_toggleGroups[i].storeCollectedHashes(
+			std::unordered_set<uint32_t>(mergedGroup.pixelShaderHashes.begin(), mergedGroup.pixelShaderHashes.end()),
+			std::unordered_set<uint32_t>(mergedGroup.vertexShaderHashes.begin(), mergedGroup.vertexShaderHashes.end()),
+			std::unordered_set<uint32_t>(mergedGroup.computeShaderHashes.begin(), mergedGroup.computeShaderHashes.end()));
+	}
+
+	syncGroupRuntimeStates();
+	saveShaderTogglerIniFile();
+
+	const std::string message = "ShaderToggler: imported hash pack, " + report.toString() + ".";
+	reshade::log_message(3, message.c_str());
+	return true;
+}
+
+// Runs the init once; a second caller blocks until the first one is done. Never call it under the loader lock.
+static void finishDeferredInit()
+{
+	if (g_deferredInitFinished.load(std::memory_order_acquire))
+	{
+		return;
 	}
 
-	iniFile.SetFileName(g_iniFileName);
-	iniFile.Save();
+	std::call_once(g_deferredInitOnce, []()
+		{
+			KeyData::refreshControllerTypeDetection();
+			loadShaderTogglerIniFile();
+		});
+	g_deferredInitFinished.store(true, std::memory_order_release);
+}
+
+static DWORD WINAPI deferredInitThread(LPVOID module)
+{
+	finishDeferredInit();
+	FreeLibraryAndExitThread(static_cast<HMODULE>(module), 0);
+}
 
-	rewriteIniWithTopAndBottomWatermark(g_iniFileName);
+static void holdModuleForWorkerThreads()
+{
+	if (nullptr == g_workerThreadModuleReference)
+	{
+		GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(&holdModuleForWorkerThreads), &g_workerThreadModuleReference);
+	}
+}
+
+// ReShade still holds its own reference while it destroys a runtime, so this never unloads the add-on.
+static void releaseModuleForWorkerThreads()
+{
+	if (nullptr != g_workerThreadModuleReference)
+	{
+		FreeLibrary(g_workerThreadModuleReference);
+		g_workerThreadModuleReference = nullptr;
+	}
+}
+
+static void startDeferredInitThread()
+{
+	HMODULE module = nullptr;
+	if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(&deferredInitThread), &module))
+	{
+		// the first device init runs it inline instead.
+		return;
+	}
+
+	HANDLE thread = CreateThread(nullptr, 0, deferredInitThread, module, 0, nullptr);
+	if (nullptr == thread)
+	{
+		FreeLibrary(module);
+		return;
+	}
+	CloseHandle(thread);
+}
+
+// Devices whose init_device fired before the add-on was registered have no data yet; the first command list,
+// pipeline or present on them creates it. Pipelines created before that point stay unknown.
+static DeviceDataContainer* getOrCreateDeviceData(device* device, bool fromInitDevice)
+{
+	DeviceDataContainer* existing = getDeviceData(device);
+	if (nullptr != existing)
+	{
+		return existing;
+	}
+
+	// bind and draw read the groups through the device data from here on, and the hunt filter comes from the
+	// config: both must see a finished load. Not under the registry lock, the load can take a while.
+	finishDeferredInit();
+
+	std::lock_guard lock(g_deviceRegistryMutex);
+	existing = getDeviceData(device);
+	if (nullptr != existing)
+	{
+		return existing;
+	}
+
+	DeviceDataContainer& deviceData = device->create_private_data<DeviceDataContainer>();
+	deviceData.pixelShaderManager.setHuntCandidateFilter(g_huntCandidateFilter);
+	deviceData.vertexShaderManager.setHuntCandidateFilter(g_huntCandidateFilter);
+	deviceData.computeShaderManager.setHuntCandidateFilter(g_huntCandidateFilter);
+	g_deviceRegistry.push_back(&deviceData);
+
+	if (!fromInitDevice)
+	{
+		reshade::log_message(2, "ShaderToggler: device was created before the add-on loaded, shaders it already created can't be toggled.");
+	}
+	return &deviceData;
+}
+
+static void onInitDevice(device *device)
+{
+	getOrCreateDeviceData(device, true);
+}
+
+static void onDestroyDevice(device *device)
+{
+	DeviceDataContainer* deviceData = getDeviceData(device);
+	if (nullptr == deviceData)
+	{
+		return;
+	}
+
+	DeviceDataContainer* huntingDeviceData = deviceData;
+	g_huntingDeviceData.compare_exchange_strong(huntingDeviceData, nullptr);
+
+	{
+		std::lock_guard lock(g_deviceRegistryMutex);
+		g_deviceRegistry.erase(std::remove(g_deviceRegistry.begin(), g_deviceRegistry.end(), deviceData), g_deviceRegistry.end());
+	}
+
+	device->destroy_private_data<DeviceDataContainer>();
 }
 
 static void onInitCommandList(command_list *commandList)
 {
-	commandList->create_private_data<CommandListDataContainer>();
+	CommandListDataContainer& commandListData = commandList->create_private_data<CommandListDataContainer>();
+	commandListData.deviceData = getOrCreateDeviceData(commandList->get_device(), false);
 }
 
 static void onDestroyCommandList(command_list *commandList)
@@ -834,22 +1892,27 @@ static void onResetCommandList(command_list *commandList)
 	commandListData.activePixelShaderPipeline = static_cast<uint64_t>(-1);
 	commandListData.activeVertexShaderPipeline = static_cast<uint64_t>(-1);
 	commandListData.activeComputeShaderPipeline = static_cast<uint64_t>(-1);
+	commandListData.hasCachedVerdict = false;
 }
 
-static void onInitPipeline(device *, pipeline_layout, uint32_t subobjectCount, const pipeline_subobject *subobjects, pipeline pipelineHandle)
+static void onInitPipeline(device *device, pipeline_layout, uint32_t subobjectCount, const pipeline_subobject *subobjects, pipeline pipelineHandle)
 {
+	DeviceDataContainer* deviceData = getOrCreateDeviceData(device, false);
+
+	const PipelineStateInfo pipelineState = PipelineStateInfo::fromSubobjects(subobjectCount, subobjects);
+
 	for (uint32_t i = 0; i < subobjectCount; ++i)
 	{
 		switch (subobjects[i].type)
 		{
 		case pipeline_subobject_type::vertex_shader:
-			g_vertexShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle);
+			deviceData->vertexShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle, pipelineState);
 			break;
 		case pipeline_subobject_type::pixel_shader:
-			g_pixelShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle);
+			deviceData->pixelShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle, pipelineState);
 			break;
 		case pipeline_subobject_type::compute_shader:
-			g_computeShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle);
+			deviceData->computeShaderManager.addHashHandlePair(calculateShaderHash(subobjects[i].data), pipelineHandle.handle, pipelineState);
 			break;
 		default:
 			break;
@@ -857,11 +1920,17 @@ static void onInitPipeline(device *, pipeline_layout, uint32_t subobjectCount, c
 	}
 }
 
-static void onDestroyPipeline(device *, pipeline pipelineHandle)
+static void onDestroyPipeline(device *device, pipeline pipelineHandle)
 {
-	g_pixelShaderManager.removeHandle(pipelineHandle.handle);
-	g_vertexShaderManager.removeHandle(pipelineHandle.handle);
-	g_computeShaderManager.removeHandle(pipelineHandle.handle);
+	DeviceDataContainer* deviceData = getDeviceData(device);
+	if (nullptr == deviceData)
+	{
+		return;
+	}
+
+	deviceData->pixelShaderManager.removeHandle(pipelineHandle.handle);
+	deviceData->vertexShaderManager.removeHandle(pipelineHandle.handle);
+	deviceData->computeShaderManager.removeHandle(pipelineHandle.handle);
 }
 
 static void displayIsPartOfToggleGroup()
@@ -902,12 +1971,12 @@ static void onReshadeOverlay(reshade::api::effect_runtime *runtime)
 
 	if (g_toggleGroupIdShaderEditing >= 0 && g_overlayOpacity > 0.0f)
 	{
-		std::string editingGroupName = "";
-		for (auto& group : g_toggleGroups)
+		const char* editingGroupName = "";
+		for (const auto& group : g_toggleGroups)
 		{
 			if (group.getId() == g_toggleGroupIdShaderEditing)
 			{
-				editingGroupName = group.getName();
+				editingGroupName = group.getName().c_str();
 				break;
 			}
 		}
@@ -923,9 +1992,10 @@ static void onReshadeOverlay(reshade::api::effect_runtime *runtime)
 			return;
 		}
 
-		displayShaderManagerStats(g_vertexShaderManager, "vertex");
-		displayShaderManagerStats(g_pixelShaderManager, "pixel");
-		displayShaderManagerStats(g_computeShaderManager, "compute");
+		DeviceDataContainer& deviceData = getHuntingDeviceData();
+		displayShaderManagerStats(deviceData.vertexShaderManager, "vertex");
+		displayShaderManagerStats(deviceData.pixelShaderManager, "pixel");
+		displayShaderManagerStats(deviceData.computeShaderManager, "compute");
 
 		if (g_activeCollectorFrameCounter > 0)
 		{
@@ -934,38 +2004,149 @@ static void onReshadeOverlay(reshade::api::effect_runtime *runtime)
 		}
 		else
 		{
-			if (g_vertexShaderManager.isInHuntingMode() || g_pixelShaderManager.isInHuntingMode() || g_computeShaderManager.isInHuntingMode())
+			if (deviceData.vertexShaderManager.isInHuntingMode() || deviceData.pixelShaderManager.isInHuntingMode() || deviceData.computeShaderManager.isInHuntingMode())
 			{
-				ImGui::Text("Editing the shaders for group: %s", editingGroupName.c_str());
+				ImGui::Text("Editing the shaders for group: %s", editingGroupName);
 			}
-			displayShaderManagerInfo(g_vertexShaderManager, "vertex");
-			displayShaderManagerInfo(g_pixelShaderManager, "pixel");
-			displayShaderManagerInfo(g_computeShaderManager, "compute");
+			displayShaderManagerInfo(deviceData.vertexShaderManager, "vertex");
+			displayShaderManagerInfo(deviceData.pixelShaderManager, "pixel");
+			displayShaderManagerInfo(deviceData.computeShaderManager, "compute");
 		}
 		ImGui::End();
 	}
 }
 
+static void reportSteadyStateAllocations(const char* hookName, uint32_t allocationCount)
+{
+	if (allocationCount == 0)
+	{
+		return;
+	}
+
+	// at most one report per ~10 seconds of frames, the hooks run far too often to log each one.
+	static std::atomic_uint32_t s_lastReportedFrameEpoch = 0;
+	const uint32_t frameEpoch = g_frameEpoch.load(std::memory_order_relaxed);
+	uint32_t lastReported = s_lastReportedFrameEpoch.load(std::memory_order_relaxed);
+	if (lastReported != 0 && frameEpoch - lastReported < 600)
+	{
+		return;
+	}
+	if (!s_lastReportedFrameEpoch.compare_exchange_strong(lastReported, frameEpoch == 0 ? 1 : frameEpoch, std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	char message[160];
+	snprintf(message, sizeof(message), "ShaderToggler: %u heap allocation(s) in %s during a steady-state frame.", allocationCount, hookName);
+	reshade::log_message(2, message);
+}
+
+static void recordBackgroundSample(DeviceDataContainer& deviceData, uint64_t pipelineHandle, bool hasPixelShader, bool hasVertexShader, bool hasComputeShader)
+{
+	const uint32_t frameEpoch = g_frameEpoch.load(std::memory_order_relaxed);
+	const bool measureThisBind =
+		(g_backgroundSamplingBindCounter.fetch_add(1, std::memory_order_relaxed) % BACKGROUND_SAMPLING_MEASURE_EVERY_NTH_BIND) == 0;
+	const auto measureStart = measureThisBind ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+	if (hasPixelShader) deviceData.pixelShaderManager.recordActivePipelineHandle(pipelineHandle, frameEpoch);
+	if (hasVertexShader) deviceData.vertexShaderManager.recordActivePipelineHandle(pipelineHandle, frameEpoch);
+	if (hasComputeShader) deviceData.computeShaderManager.recordActivePipelineHandle(pipelineHandle, frameEpoch);
+
+	if (measureThisBind)
+	{
+		const auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - measureStart).count();
+		g_backgroundSamplingMeasuredNs.fetch_add(static_cast<uint64_t>(elapsedNs), std::memory_order_relaxed);
+		g_backgroundSamplingMeasuredBinds.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+static void recordShaderActivityHistory(ShaderManager& shaderManager, ShaderActivityHistory& history, uint32_t frameEpoch)
+{
+	if (history.isFrozen())
+	{
+		return;
+	}
+
+	shaderManager.fillActiveBitsForFrame(frameEpoch, g_shaderActivityBitsScratch);
+	history.commitFrame(frameEpoch, g_shaderActivityBitsScratch);
+}
+
+// Starts a new frame epoch and returns it.
+static uint32_t advanceBackgroundSampling(const std::chrono::steady_clock::time_point& now)
+{
+	if (g_backgroundSamplingThisFrame)
+	{
+		DeviceDataContainer& deviceData = getHuntingDeviceData();
+		const uint32_t finishedFrameEpoch = g_frameEpoch.load(std::memory_order_relaxed);
+		recordShaderActivityHistory(deviceData.pixelShaderManager, g_pixelShaderActivityHistory, finishedFrameEpoch);
+		recordShaderActivityHistory(deviceData.vertexShaderManager, g_vertexShaderActivityHistory, finishedFrameEpoch);
+		recordShaderActivityHistory(deviceData.computeShaderManager, g_computeShaderActivityHistory, finishedFrameEpoch);
+	}
+
+	const uint32_t frameEpoch = g_frameEpoch.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	if (!g_backgroundSamplingEnabled)
+	{
+		g_backgroundSamplingThisFrame = false;
+		return frameEpoch;
+	}
+
+	if (std::chrono::duration_cast<std::chrono::milliseconds>(now - g_backgroundSamplingLastBudgetCheck).count() >= 1000)
+	{
+		const uint32_t measuredBinds = g_backgroundSamplingMeasuredBinds.exchange(0, std::memory_order_relaxed);
+		const uint64_t measuredNs = g_backgroundSamplingMeasuredNs.exchange(0, std::memory_order_relaxed);
+		if (measuredBinds > 0)
+		{
+			g_backgroundSamplingAverageNs = static_cast<float>(measuredNs) / static_cast<float>(measuredBinds);
+
+			uint32_t interval = g_backgroundSamplingFrameInterval;
+			if (g_backgroundSamplingAverageNs > BACKGROUND_SAMPLING_BUDGET_NS && interval < BACKGROUND_SAMPLING_MAX_FRAME_INTERVAL)
+				interval *= 2;
+			else if (g_backgroundSamplingAverageNs < BACKGROUND_SAMPLING_BUDGET_NS / 2 && interval > 1)
+				interval /= 2;
+			g_backgroundSamplingFrameInterval = interval;
+		}
+		g_backgroundSamplingLastBudgetCheck = now;
+	}
+
+	g_backgroundSamplingThisFrame = (frameEpoch % g_backgroundSamplingFrameInterval) == 0;
+	return frameEpoch;
+}
+
 static void onBindPipeline(command_list* commandList, pipeline_stage stages, pipeline pipelineHandle)
 {
+	const ScopedAllocationCounter allocationCounter;
+
 	if (nullptr != commandList && pipelineHandle.handle != 0)
 	{
-		const bool handleHasPixelShaderAttached = g_pixelShaderManager.isKnownHandle(pipelineHandle.handle);
-		const bool handleHasVertexShaderAttached = g_vertexShaderManager.isKnownHandle(pipelineHandle.handle);
-		const bool handleHasComputeShaderAttached = g_computeShaderManager.isKnownHandle(pipelineHandle.handle);
+		CommandListDataContainer& commandListData = commandList->get_private_data<CommandListDataContainer>();
+		if (nullptr == commandListData.deviceData)
+		{
+			return;
+		}
+
+		DeviceDataContainer& deviceData = *commandListData.deviceData;
+		const bool handleHasPixelShaderAttached = deviceData.pixelShaderManager.isKnownHandle(pipelineHandle.handle);
+		const bool handleHasVertexShaderAttached = deviceData.vertexShaderManager.isKnownHandle(pipelineHandle.handle);
+		const bool handleHasComputeShaderAttached = deviceData.computeShaderManager.isKnownHandle(pipelineHandle.handle);
 
 		if (!handleHasPixelShaderAttached && !handleHasVertexShaderAttached && !handleHasComputeShaderAttached)
 		{
 			return;
 		}
 
-		CommandListDataContainer& commandListData = commandList->get_private_data<CommandListDataContainer>();
+		commandListData.hasCachedVerdict = false;
+
+		if (g_backgroundSamplingThisFrame)
+		{
+			recordBackgroundSample(deviceData, pipelineHandle.handle, handleHasPixelShaderAttached, handleHasVertexShaderAttached, handleHasComputeShaderAttached);
+		}
 
 		if (g_activeCollectorFrameCounter > 0)
 		{
-			if (handleHasPixelShaderAttached) g_pixelShaderManager.addActivePipelineHandle(pipelineHandle.handle);
-			if (handleHasVertexShaderAttached) g_vertexShaderManager.addActivePipelineHandle(pipelineHandle.handle);
-			if (handleHasComputeShaderAttached) g_computeShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (handleHasPixelShaderAttached) deviceData.pixelShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (handleHasVertexShaderAttached) deviceData.vertexShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (handleHasComputeShaderAttached) deviceData.computeShaderManager.addActivePipelineHandle(pipelineHandle.handle);
 		}
 		else
 		{
@@ -976,20 +2157,26 @@ static void onBindPipeline(command_list* commandList, pipeline_stage stages, pip
 
 		if ((stages & pipeline_stage::pixel_shader) == pipeline_stage::pixel_shader && handleHasPixelShaderAttached)
 		{
-			if (g_activeCollectorFrameCounter > 0) g_pixelShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (g_activeCollectorFrameCounter > 0) deviceData.pixelShaderManager.addActivePipelineHandle(pipelineHandle.handle);
 			commandListData.activePixelShaderPipeline = pipelineHandle.handle;
 		}
 		if ((stages & pipeline_stage::vertex_shader) == pipeline_stage::vertex_shader && handleHasVertexShaderAttached)
 		{
-			if (g_activeCollectorFrameCounter > 0) g_vertexShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (g_activeCollectorFrameCounter > 0) deviceData.vertexShaderManager.addActivePipelineHandle(pipelineHandle.handle);
 			commandListData.activeVertexShaderPipeline = pipelineHandle.handle;
 		}
 		if ((stages & pipeline_stage::compute_shader) == pipeline_stage::compute_shader && handleHasComputeShaderAttached)
 		{
-			if (g_activeCollectorFrameCounter > 0) g_computeShaderManager.addActivePipelineHandle(pipelineHandle.handle);
+			if (g_activeCollectorFrameCounter > 0) deviceData.computeShaderManager.addActivePipelineHandle(pipelineHandle.handle);
 			commandListData.activeComputeShaderPipeline = pipelineHandle.handle;
 		}
 	}
+
+	// collecting active shaders inserts into the managers' sets, that's the one expected allocation here.
+	if (g_activeCollectorFrameCounter == 0)
+	{
+		reportSteadyStateAllocations("bind_pipeline", allocationCounter.getCount());
+	}
 }
 
 bool blockDrawCallForCommandList(command_list* commandList)
@@ -999,10 +2186,23 @@ bool blockDrawCallForCommandList(command_list* commandList)
 		return false;
 	}
 
-	const CommandListDataContainer &commandListData = commandList->get_private_data<CommandListDataContainer>();
+	const ScopedAllocationCounter allocationCounter;
+	CommandListDataContainer &commandListData = commandList->get_private_data<CommandListDataContainer>();
+	if (nullptr == commandListData.deviceData)
+	{
+		return false;
+	}
+
+	// group and hunting state only change in present, which starts a new epoch.
+	const uint32_t frameEpoch = g_frameEpoch.load(std::memory_order_relaxed);
+	if (commandListData.hasCachedVerdict && commandListData.verdictFrameEpoch == frameEpoch)
+	{
+		return commandListData.cachedVerdictBlocks;
+	}
 
-	uint32_t shaderHash = g_pixelShaderManager.getShaderHash(commandListData.activePixelShaderPipeline);
-	bool blockCall = g_pixelShaderManager.isBlockedShader(shaderHash);
+	DeviceDataContainer& deviceData = *commandListData.deviceData;
+	uint32_t shaderHash = deviceData.pixelShaderManager.getShaderHash(commandListData.activePixelShaderPipeline);
+	bool blockCall = deviceData.pixelShaderManager.isBlockedShader(shaderHash);
 	for (auto& group : g_toggleGroups)
 	{
 		for (auto hash : group.getPixelShaderHashes())
@@ -1015,8 +2215,8 @@ bool blockDrawCallForCommandList(command_list* commandList)
 		}
 	}
 
-	shaderHash = g_vertexShaderManager.getShaderHash(commandListData.activeVertexShaderPipeline);
-	blockCall |= g_vertexShaderManager.isBlockedShader(shaderHash);
+	shaderHash = deviceData.vertexShaderManager.getShaderHash(commandListData.activeVertexShaderPipeline);
+	blockCall |= deviceData.vertexShaderManager.isBlockedShader(shaderHash);
 	for (auto& group : g_toggleGroups)
 	{
 		for (auto hash : group.getVertexShaderHashes())
@@ -1029,8 +2229,8 @@ bool blockDrawCallForCommandList(command_list* commandList)
 		}
 	}
 
-	shaderHash = g_computeShaderManager.getShaderHash(commandListData.activeComputeShaderPipeline);
-	blockCall |= g_computeShaderManager.isBlockedShader(shaderHash);
+	shaderHash = deviceData.computeShaderManager.getShaderHash(commandListData.activeComputeShaderPipeline);
+	blockCall |= deviceData.computeShaderManager.isBlockedShader(shaderHash);
 	for (auto& group : g_toggleGroups)
 	{
 		for (auto hash : group.getComputeShaderHashes())
@@ -1043,6 +2243,11 @@ bool blockDrawCallForCommandList(command_list* commandList)
 		}
 	}
 
+	commandListData.verdictFrameEpoch = frameEpoch;
+	commandListData.hasCachedVerdict = true;
+	commandListData.cachedVerdictBlocks = blockCall;
+
+	reportSteadyStateAllocations("draw", allocationCounter.getCount());
 	return blockCall;
 }
 
@@ -1066,393 +2271,405 @@ static bool onDrawOrDispatchIndirect(command_list* commandList, indirect_command
 	case indirect_command::dispatch:
 		return blockDrawCallForCommandList(commandList);
 	default:
-		return false;
-	}
-}
-
-static void onReshadePresent(effect_runtime* runtime)
-{
-	const auto mouseCaptureNow = std::chrono::steady_clock::now();
-	const bool mouseCapturedByOverlay =
-		g_overlayMouseCaptureLastSeen.time_since_epoch().count() != 0 &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(
-			mouseCaptureNow - g_overlayMouseCaptureLastSeen).count() <= 100;
-	KeyData::setMouseHotkeysBlocked(mouseCapturedByOverlay);
-
-	if (g_activeCollectorFrameCounter > 0)
-	{
-		--g_activeCollectorFrameCounter;
-	}
-
-	bool suspensionToggledThisFrame = false;
-	if (g_allToggleGroupsSuspended)
-	{
-		if (isAnyGlobalHotkeyPressed(g_globalRestoreHotkeys, runtime))
-		{
-			restoreAllToggleGroups();
-			suspensionToggledThisFrame = true;
-		}
-	}
-	else
-	{
-		if (isAnyGlobalHotkeyPressed(g_globalSuspendHotkeys, runtime))
-		{
-			suspendAllToggleGroups();
-			suspensionToggledThisFrame = true;
-		}
-	}
-
-	if (g_allToggleGroupsSuspended)
-	{
-		for (auto& group : g_toggleGroups)
-		{
-			const bool isDownNow = group.getToggleKey().isKeyDown(runtime);
-			bool& wasDownLastFrame = g_groupHotkeyWasDown[group.getId()];
-
-			if (!group.isTimedMode() &&
-				!group.isHoldMode() &&
-				isDownNow &&
-				!wasDownLastFrame &&
-				!suspensionToggledThisFrame)
-			{
-				const int groupId = group.getId();
-				auto pendingIt = g_pendingSuspendedGroupToggles.find(groupId);
-				if (pendingIt == g_pendingSuspendedGroupToggles.end())
-					g_pendingSuspendedGroupToggles.insert(groupId);
-				else
-					g_pendingSuspendedGroupToggles.erase(pendingIt);
-			}
+		return false;
+	}
+}
 
-			wasDownLastFrame = isDownNow;
+static void updateToggleGroup(ToggleGroup& group, GroupRuntimeState& state, const KeyData::InputSnapshot& input,
+	const std::chrono::steady_clock::time_point& nowTime)
+{
+	if (state.startupActivationStartTime)
+	{
+		const auto startupElapsedMs =
+			std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - *state.startupActivationStartTime).count();
+
+		if (startupElapsedMs >= group.getStartupDurationMs())
+		{
+			setGroupActiveWithEditRefresh(group, false);
+			state.startupActivationStartTime.reset();
 		}
 	}
-	else if (!suspensionToggledThisFrame)
-	{
-	for (auto& group : g_toggleGroups)
+
+	const bool isDownNow = group.getToggleKey().isKeyDown(input);
+
+	const bool timedSuppressionKeyDownNow = isAnyTimedSuppressionKeyDown(group, input);
+	if (timedSuppressionKeyDownNow)
 	{
-		const auto nowTime = std::chrono::steady_clock::now();
+		state.lastTimedSuppressionInputTime = nowTime;
+	}
 
-		auto startupTimerIt = g_groupStartupActivationStartTime.find(group.getId());
-		if (startupTimerIt != g_groupStartupActivationStartTime.end())
+	bool timedSuppressedNow = timedSuppressionKeyDownNow;
+	if (!timedSuppressedNow)
+	{
+		if (state.lastTimedSuppressionInputTime)
 		{
-			const auto startupElapsedMs =
-				std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - startupTimerIt->second).count();
+			const auto elapsedSinceSuppressionMs =
+				std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - *state.lastTimedSuppressionInputTime).count();
 
-			if (startupElapsedMs >= group.getStartupDurationMs())
+			if (elapsedSinceSuppressionMs <= group.getTimedSuppressionLingerMs())
+			{
+				timedSuppressedNow = true;
+			}
+			else
 			{
-				setGroupActiveWithEditRefresh(group, false);
-				g_groupStartupActivationStartTime.erase(startupTimerIt);
+				state.lastTimedSuppressionInputTime.reset();
 			}
 		}
+	}
+
+	const bool timedTriggerActiveNow = !timedSuppressedNow && isAnyTimedTriggerActive(group, input);
 
-		const bool isDownNow = group.getToggleKey().isKeyDown(runtime);
+	if (group.isTimedMode())
+	{
+		const bool timedTargetActiveState = !group.isTimedModeInverted();
+		const bool timedRestingActiveState = group.isTimedModeInverted();
 
-		const bool timedSuppressionKeyDownNow = isAnyTimedSuppressionKeyDown(group, runtime);
-		if (timedSuppressionKeyDownNow)
+		if (timedSuppressedNow)
 		{
-			g_groupLastTimedSuppressionInputTime[group.getId()] = nowTime;
+			setGroupActiveWithEditRefresh(group, timedRestingActiveState);
+			state.lastTimedTriggerTime.reset();
+			state.timedVisibleSince.reset();
+			state.timedFadeOutStart.reset();
+			state.hotkeyWasDown = isDownNow;
+			return;
 		}
 
-		bool timedSuppressedNow = timedSuppressionKeyDownNow;
-		if (!timedSuppressedNow)
+		if (timedTriggerActiveNow)
 		{
-			auto suppressionIt = g_groupLastTimedSuppressionInputTime.find(group.getId());
-			if (suppressionIt != g_groupLastTimedSuppressionInputTime.end())
+			if (group.isActive() != timedTargetActiveState)
 			{
-				const auto elapsedSinceSuppressionMs =
-					std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - suppressionIt->second).count();
-
-				if (elapsedSinceSuppressionMs <= group.getTimedSuppressionLingerMs())
-				{
-					timedSuppressedNow = true;
-				}
-				else
-				{
-					g_groupLastTimedSuppressionInputTime.erase(suppressionIt);
-				}
+				state.timedVisibleSince = nowTime;
 			}
-		}
 
-		const bool timedTriggerActiveNow = !timedSuppressedNow && isAnyTimedTriggerActive(group, runtime);
+			setGroupActiveWithEditRefresh(group, timedTargetActiveState);
+			state.lastTimedTriggerTime = nowTime;
+			state.timedFadeOutStart.reset();
+		}
 
-		if (group.isTimedMode())
+		if (group.isActive() == timedTargetActiveState)
 		{
-			const bool timedTargetActiveState = !group.isTimedModeInverted();
-			const bool timedRestingActiveState = group.isTimedModeInverted();
-
-			if (timedSuppressedNow)
+			if (state.lastTimedTriggerTime)
 			{
-				setGroupActiveWithEditRefresh(group, timedRestingActiveState);
-				g_groupLastTimedTriggerTime.erase(group.getId());
-				g_groupTimedVisibleSince.erase(group.getId());
-				g_groupTimedFadeOutStart.erase(group.getId());
-				g_groupHotkeyWasDown[group.getId()] = isDownNow;
-				continue;
-			}
+				const auto elapsedSinceLastTriggerMs =
+					std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - *state.lastTimedTriggerTime).count();
 
-			if (timedTriggerActiveNow)
-			{
-				if (group.isActive() != timedTargetActiveState)
+				long long elapsedVisibleMs = 0;
+				if (state.timedVisibleSince)
 				{
-					g_groupTimedVisibleSince[group.getId()] = nowTime;
+					elapsedVisibleMs =
+						std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - *state.timedVisibleSince).count();
 				}
 
-				setGroupActiveWithEditRefresh(group, timedTargetActiveState);
-				g_groupLastTimedTriggerTime[group.getId()] = nowTime;
-				g_groupTimedFadeOutStart.erase(group.getId());
-			}
-
-			if (group.isActive() == timedTargetActiveState)
-			{
-				auto lastTriggerIt = g_groupLastTimedTriggerTime.find(group.getId());
-				auto visibleSinceIt = g_groupTimedVisibleSince.find(group.getId());
-				auto fadeOutIt = g_groupTimedFadeOutStart.find(group.getId());
+				const bool hideDelayExpired = elapsedSinceLastTriggerMs >= group.getTimedModeDelayMs();
+				const bool minVisibleExpired = elapsedVisibleMs >= group.getTimedModeMinVisibleMs();
 
-				if (lastTriggerIt != g_groupLastTimedTriggerTime.end())
+				if (hideDelayExpired && minVisibleExpired)
 				{
-					const auto elapsedSinceLastTriggerMs =
-						std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - lastTriggerIt->second).count();
-
-					long long elapsedVisibleMs = 0;
-					if (visibleSinceIt != g_groupTimedVisibleSince.end())
+					if (group.getTimedModeFadeOutMs() <= 0)
 					{
-						elapsedVisibleMs =
-							std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - visibleSinceIt->second).count();
+						setGroupActiveWithEditRefresh(group, timedRestingActiveState);
+						state.timedVisibleSince.reset();
+						state.timedFadeOutStart.reset();
 					}
-
-					const bool hideDelayExpired = elapsedSinceLastTriggerMs >= group.getTimedModeDelayMs();
-					const bool minVisibleExpired = elapsedVisibleMs >= group.getTimedModeMinVisibleMs();
-
-					if (hideDelayExpired && minVisibleExpired)
+					else
 					{
-						if (group.getTimedModeFadeOutMs() <= 0)
+						if (!state.timedFadeOutStart)
 						{
-							setGroupActiveWithEditRefresh(group, timedRestingActiveState);
-							g_groupTimedVisibleSince.erase(group.getId());
-							g_groupTimedFadeOutStart.erase(group.getId());
+							state.timedFadeOutStart = nowTime;
 						}
 						else
 						{
-							if (fadeOutIt == g_groupTimedFadeOutStart.end())
-							{
-								g_groupTimedFadeOutStart[group.getId()] = nowTime;
-							}
-							else
+							const auto fadeElapsedMs =
+								std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - *state.timedFadeOutStart).count();
+
+							if (fadeElapsedMs >= group.getTimedModeFadeOutMs())
 							{
-								const auto fadeElapsedMs =
-									std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - fadeOutIt->second).count();
-
-								if (fadeElapsedMs >= group.getTimedModeFadeOutMs())
-								{
-									setGroupActiveWithEditRefresh(group, timedRestingActiveState);
-									g_groupTimedVisibleSince.erase(group.getId());
-									g_groupTimedFadeOutStart.erase(group.getId());
-								}
+								setGroupActiveWithEditRefresh(group, timedRestingActiveState);
+								state.timedVisibleSince.reset();
+								state.timedFadeOutStart.reset();
 							}
 						}
 					}
-					else
-					{
-						g_groupTimedFadeOutStart.erase(group.getId());
-					}
+				}
+				else
+				{
+					state.timedFadeOutStart.reset();
 				}
 			}
-			else
-			{
-				g_groupTimedVisibleSince.erase(group.getId());
-				g_groupTimedFadeOutStart.erase(group.getId());
-			}
-
-			g_groupHotkeyWasDown[group.getId()] = isDownNow;
-			continue;
-		}
-
-		if (group.isHoldMode())
-		{
-			const bool desiredActive = group.isHoldInverted() ? !isDownNow : isDownNow;
-			setGroupActiveWithEditRefresh(group, desiredActive);
-			g_groupHotkeyWasDown[group.getId()] = isDownNow;
-			continue;
 		}
-
-		bool& wasDownLastFrame = g_groupHotkeyWasDown[group.getId()];
-		auto& lastToggleTime = g_groupHotkeyLastToggleTime[group.getId()];
-
-		const auto msSinceLastToggle =
-			std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - lastToggleTime).count();
-
-		if (isDownNow && !wasDownLastFrame && msSinceLastToggle > g_groupHotkeyDebounceMs)
+		else
 		{
-			setGroupActiveWithEditRefresh(group, !group.isActive());
-			lastToggleTime = nowTime;
+			state.timedVisibleSince.reset();
+			state.timedFadeOutStart.reset();
 		}
 
-		wasDownLastFrame = isDownNow;
+		state.hotkeyWasDown = isDownNow;
+		return;
 	}
+
+	if (group.isHoldMode())
+	{
+		const bool desiredActive = group.isHoldInverted() ? !isDownNow : isDownNow;
+		setGroupActiveWithEditRefresh(group, desiredActive);
+		state.hotkeyWasDown = isDownNow;
+		return;
 	}
 
-	const bool ctrlDown = runtime->is_key_down(VK_CONTROL);
-	auto now = std::chrono::steady_clock::now();
+	bool& wasDownLastFrame = state.hotkeyWasDown;
+	auto& lastToggleTime = state.hotkeyLastToggleTime;
 
-	const int NP1 = VK_NUMPAD1;
-	const int NP2 = VK_NUMPAD2;
-	const int NP3 = VK_NUMPAD3;
-	const int NP4 = VK_NUMPAD4;
-	const int NP5 = VK_NUMPAD5;
-	const int NP6 = VK_NUMPAD6;
-	const int NP7 = VK_NUMPAD7;
-	const int NP8 = VK_NUMPAD8;
-	const int NP9 = VK_NUMPAD9;
+	const auto msSinceLastToggle =
+		std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - lastToggleTime).count();
 
-	bool np1Down = is_key_down_numpad_only(runtime, NP1);
-	bool np1Pressed = np1Down && !s_prevNP1Down;
-	if (np1Pressed)
+	if (isDownNow && !wasDownLastFrame && msSinceLastToggle > g_groupHotkeyDebounceMs)
 	{
-		g_pixelShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP1 = now;
-		s_holdStartNP1 = now;
-		s_np1Held = true;
+		setGroupActiveWithEditRefresh(group, !group.isActive());
+		lastToggleTime = nowTime;
 	}
-	else if (np1Down && s_np1Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP1).count() >= getAcceleratedRepeatMs(s_holdStartNP1, now))
+
+	wasDownLastFrame = isDownNow;
+}
+
+// Earliest time at which updateToggleGroup() would change something for the group without new input.
+static void scheduleToggleGroupDeadline(uint32_t slot, const ToggleGroup& group, const GroupRuntimeState& state)
+{
+	using std::chrono::milliseconds;
+
+	auto deadline = GroupDeadlineScheduler::TimePoint::max();
+
+	if (state.startupActivationStartTime)
 	{
-		g_pixelShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP1 = now;
+		deadline = std::min(deadline, *state.startupActivationStartTime + milliseconds(group.getStartupDurationMs()));
 	}
-	else if (!np1Down)
+
+	if (state.lastTimedSuppressionInputTime)
 	{
-		s_np1Held = false;
+		// suppression lingers while the elapsed whole milliseconds are <= the linger time.
+		deadline = std::min(deadline, *state.lastTimedSuppressionInputTime + milliseconds(group.getTimedSuppressionLingerMs() + 1));
 	}
-	s_prevNP1Down = np1Down;
 
-	bool np2Down = is_key_down_numpad_only(runtime, NP2);
-	bool np2Pressed = np2Down && !s_prevNP2Down;
-	if (np2Pressed)
+	if (group.isTimedMode() && group.isActive() == !group.isTimedModeInverted())
 	{
-		g_pixelShaderManager.huntNextShader(ctrlDown);
-		s_lastNP2 = now;
-		s_holdStartNP2 = now;
-		s_np2Held = true;
+		if (state.timedFadeOutStart)
+		{
+			deadline = std::min(deadline, *state.timedFadeOutStart + milliseconds(group.getTimedModeFadeOutMs()));
+		}
+		else if (state.lastTimedTriggerTime)
+		{
+			// without a visible-since time the minimum visible time counts as zero elapsed.
+			auto hideAt = *state.lastTimedTriggerTime + milliseconds(group.getTimedModeDelayMs());
+			if (state.timedVisibleSince)
+			{
+				hideAt = std::max(hideAt, *state.timedVisibleSince + milliseconds(group.getTimedModeMinVisibleMs()));
+			}
+
+			if (state.timedVisibleSince || group.getTimedModeMinVisibleMs() <= 0)
+			{
+				deadline = std::min(deadline, hideAt);
+			}
+		}
 	}
-	else if (np2Down && s_np2Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP2).count() >= getAcceleratedRepeatMs(s_holdStartNP2, now))
+
+	g_groupDeadlineScheduler.schedule(slot, deadline);
+}
+
+
+// Returns true if the runtime is (or just became) the one that runs the per-frame pass.
+static bool isPrimaryEffectRuntime(effect_runtime* runtime, std::chrono::steady_clock::time_point now)
+{
+	const auto nowTicks = now.time_since_epoch().count();
+	effect_runtime* primary = g_primaryEffectRuntime.load();
+	if (primary != runtime)
 	{
-		g_pixelShaderManager.huntNextShader(ctrlDown);
-		s_lastNP2 = now;
+		const auto idleMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::duration(nowTicks - g_primaryEffectRuntimeLastPresent.load())).count();
+		if (primary != nullptr && idleMs <= PRIMARY_EFFECT_RUNTIME_TIMEOUT_MS)
+		{
+			return false;
+		}
+
+		if (!g_primaryEffectRuntime.compare_exchange_strong(primary, runtime))
+		{
+			return false;
+		}
 	}
-	else if (!np2Down)
+
+	g_primaryEffectRuntimeLastPresent = nowTicks;
+	return true;
+}
+
+
+static void onDestroyEffectRuntime(effect_runtime* runtime)
+{
+	effect_runtime* primary = runtime;
+	if (!g_primaryEffectRuntime.compare_exchange_strong(primary, nullptr))
 	{
-		s_np2Held = false;
+		// a secondary runtime went away; the primary keeps polling.
+		return;
 	}
-	s_prevNP2Down = np2Down;
 
-	bool np3Down = is_key_down_numpad_only(runtime, NP3);
-	bool np3Pressed = np3Down && !s_prevNP3Down;
-	if (np3Pressed)
+	// Stop the controller and save threads while the add-on can still wait for them; they restart on the next
+	// present if needed. Stopping the save thread writes a pending save.
+	KeyData::stopGamepadPollingThread();
+	g_configPersistence.stop();
+	releaseModuleForWorkerThreads();
+
+	// a reload parse still running is dropped; the next present polls the file again.
+	if (g_iniReloadParse.valid())
 	{
-		g_pixelShaderManager.toggleMarkOnHuntedShader();
+		g_iniReloadParse.wait();
+		g_iniReloadParse = {};
+		g_iniFileStamp = IniFileStamp();
 	}
-	s_prevNP3Down = np3Down;
+}
+
+
+static void onReshadePresent(effect_runtime* runtime)
+{
+	const ScopedAllocationCounter allocationCounter;
+	const bool collectingThisFrame = g_activeCollectorFrameCounter > 0;
+
+	finishDeferredInit();
 
-	bool np4Down = is_key_down_numpad_only(runtime, NP4);
-	bool np4Pressed = np4Down && !s_prevNP4Down;
-	if (np4Pressed)
+	const auto presentNow = g_groupDeadlineScheduler.now();
+	if (!isPrimaryEffectRuntime(runtime, presentNow))
 	{
-		g_vertexShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP4 = now;
-		s_holdStartNP4 = now;
-		s_np4Held = true;
+		// secondary swapchains only render; the overlay is drawn per runtime by ReShade itself.
+		return;
 	}
-	else if (np4Down && s_np4Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP4).count() >= getAcceleratedRepeatMs(s_holdStartNP4, now))
+
+	// hunting follows the device the primary runtime presents on; recorded dense indices belong to the old one.
+	DeviceDataContainer* presentDeviceData = getOrCreateDeviceData(runtime->get_device(), false);
+	if (presentDeviceData != g_huntingDeviceData.load())
 	{
-		g_vertexShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP4 = now;
+		g_huntingDeviceData = presentDeviceData;
+		g_pixelShaderActivityHistory.clear();
+		g_vertexShaderActivityHistory.clear();
+		g_computeShaderActivityHistory.clear();
 	}
-	else if (!np4Down)
+
+	const bool mouseCapturedByOverlay =
+		g_overlayMouseCaptureLastSeen.time_since_epoch().count() != 0 &&
+		std::chrono::duration_cast<std::chrono::milliseconds>(
+			presentNow - g_overlayMouseCaptureLastSeen).count() <= 100;
+	KeyData::setMouseHotkeysBlocked(mouseCapturedByOverlay);
+
+	if (!g_configPersistence.isRunning())
 	{
-		s_np4Held = false;
+		holdModuleForWorkerThreads();
+		g_configPersistence.start(CONFIG_SAVE_DEBOUNCE_MS, CONFIG_SAVE_MAX_DELAY_MS);
 	}
-	s_prevNP4Down = np4Down;
 
-	bool np5Down = is_key_down_numpad_only(runtime, NP5);
-	bool np5Pressed = np5Down && !s_prevNP5Down;
-	if (np5Pressed)
+	pollIniFileReload(presentNow);
+	syncGroupRuntimeStates();
+	updateHotkeyDispatchIndex();
+	KeyData::captureInputSnapshot(runtime, g_hotkeyInterestMask, g_inputSnapshot);
+	const KeyData::InputSnapshot& input = g_inputSnapshot;
+
+	g_frameClock.now = presentNow;
+	g_frameClock.epoch = advanceBackgroundSampling(presentNow);
+	const FrameClock& frameClock = g_frameClock;
+
+	if (g_activeCollectorFrameCounter > 0)
 	{
-		g_vertexShaderManager.huntNextShader(ctrlDown);
-		s_lastNP5 = now;
-		s_holdStartNP5 = now;
-		s_np5Held = true;
+		--g_activeCollectorFrameCounter;
 	}
-	else if (np5Down && s_np5Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP5).count() >= getAcceleratedRepeatMs(s_holdStartNP5, now))
+
+	bool suspensionToggledThisFrame = false;
+	if (g_allToggleGroupsSuspended)
 	{
-		g_vertexShaderManager.huntNextShader(ctrlDown);
-		s_lastNP5 = now;
+		if (isAnyGlobalHotkeyPressed(g_globalRestoreHotkeys, input))
+		{
+			restoreAllToggleGroups(frameClock.now);
+			suspensionToggledThisFrame = true;
+		}
 	}
-	else if (!np5Down)
+	else
 	{
-		s_np5Held = false;
+		if (isAnyGlobalHotkeyPressed(g_globalSuspendHotkeys, input))
+		{
+			suspendAllToggleGroups(frameClock.now);
+			suspensionToggledThisFrame = true;
+		}
 	}
-	s_prevNP5Down = np5Down;
 
-	bool np6Down = is_key_down_numpad_only(runtime, NP6);
-	bool np6Pressed = np6Down && !s_prevNP6Down;
-	if (np6Pressed)
+	if (g_allToggleGroupsSuspended)
 	{
-		g_vertexShaderManager.toggleMarkOnHuntedShader();
-	}
-	s_prevNP6Down = np6Down;
+		for (size_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+		{
+			auto& group = g_toggleGroups[slot];
+			const bool isDownNow = group.getToggleKey().isKeyDown(input);
+			bool& wasDownLastFrame = g_groupRuntimeStates[slot].hotkeyWasDown;
 
-	bool np7Down = is_key_down_numpad_only(runtime, NP7);
-	bool np7Pressed = np7Down && !s_prevNP7Down;
-	if (np7Pressed)
-	{
-		g_computeShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP7 = now;
-		s_holdStartNP7 = now;
-		s_np7Held = true;
-	}
-	else if (np7Down && s_np7Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP7).count() >= getAcceleratedRepeatMs(s_holdStartNP7, now))
-	{
-		g_computeShaderManager.huntPreviousShader(ctrlDown);
-		s_lastNP7 = now;
+			if (!group.isTimedMode() &&
+				!group.isHoldMode() &&
+				isDownNow &&
+				!wasDownLastFrame &&
+				!suspensionToggledThisFrame)
+			{
+				const int groupId = group.getId();
+				auto pendingIt = g_pendingSuspendedGroupToggles.find(groupId);
+				if (pendingIt == g_pendingSuspendedGroupToggles.end())
+					g_pendingSuspendedGroupToggles.insert(groupId);
+				else
+					g_pendingSuspendedGroupToggles.erase(pendingIt);
+			}
+
+			wasDownLastFrame = isDownNow;
+		}
 	}
-	else if (!np7Down)
+	else if (!suspensionToggledThisFrame)
 	{
-		s_np7Held = false;
-	}
-	s_prevNP7Down = np7Down;
+	const auto nowTime = frameClock.now;
 
-	bool np8Down = is_key_down_numpad_only(runtime, NP8);
-	bool np8Pressed = np8Down && !s_prevNP8Down;
-	if (np8Pressed)
+	if (g_groupFullUpdatePending)
 	{
-		g_computeShaderManager.huntNextShader(ctrlDown);
-		s_lastNP8 = now;
-		s_holdStartNP8 = now;
-		s_np8Held = true;
+		for (uint32_t slot = 0; slot < g_toggleGroups.size(); ++slot)
+			queueGroupUpdate(slot);
+		g_groupFullUpdatePending = false;
 	}
-	else if (np8Down && s_np8Held &&
-		std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastNP8).count() >= getAcceleratedRepeatMs(s_holdStartNP8, now))
+	else
 	{
-		g_computeShaderManager.huntNextShader(ctrlDown);
-		s_lastNP8 = now;
+		g_groupDeadlineScheduler.popExpired(nowTime, queueGroupUpdate);
+
+		// Keys that went down or up since the last frame, plus the ones still held: held timed triggers and
+		// suppression keys keep refreshing their timers, and modifier changes only show on held keys.
+		KeyData::InputKeyMask changedOrHeld;
+		for (int word = 0; word < 4; ++word)
+			changedOrHeld.bits[word] = input.down.bits[word] | input.pressed.bits[word] | g_previousInputDown.bits[word];
+
+		forEachKeyInMask(changedOrHeld, [](uint8_t code)
+			{
+				for (uint32_t i = g_hotkeyDispatchOffsets[code]; i < g_hotkeyDispatchOffsets[code + 1]; ++i)
+					queueGroupUpdate(g_hotkeyDispatchSlots[i]);
+			});
 	}
-	else if (!np8Down)
+
+	g_groupsUpdatedThisFrame = g_groupUpdateSlots.size();
+	for (const uint32_t slot : g_groupUpdateSlots)
 	{
-		s_np8Held = false;
+		GroupRuntimeState& state = g_groupRuntimeStates[slot];
+		state.updateQueued = false;
+		updateToggleGroup(g_toggleGroups[slot], state, input, nowTime);
+		scheduleToggleGroupDeadline(slot, g_toggleGroups[slot], state);
+	}
+	g_groupUpdateSlots.clear();
 	}
-	s_prevNP8Down = np8Down;
 
-	bool np9Down = is_key_down_numpad_only(runtime, NP9);
-	bool np9Pressed = np9Down && !s_prevNP9Down;
-	if (np9Pressed)
+	g_previousInputDown = input.down;
+
+	updateHuntingNavigation(input, frameClock.now);
+
+	// key presses, group updates and shader collection may allocate, a frame without any of them must not.
+	bool anyKeyPressed = false;
+	for (const uint64_t word : input.pressed.bits)
+		anyKeyPressed |= word != 0;
+
+	if (!collectingThisFrame && !suspensionToggledThisFrame && !anyKeyPressed && g_groupsUpdatedThisFrame == 0)
 	{
-		g_computeShaderManager.toggleMarkOnHuntedShader();
+		reportSteadyStateAllocations("reshade_present", allocationCounter.getCount());
 	}
-	s_prevNP9Down = np9Down;
+	g_groupsUpdatedThisFrame = 0;
 }
 
 
@@ -1488,6 +2705,7 @@ static void endGlobalHotkeyEditing(
 			else if (slotIndex == static_cast<int>(hotkeys.size()))
 				hotkeys.push_back(g_keyCollector);
 
+			g_hotkeyDispatchDirty = true;
 			saveShaderTogglerIniFile();
 		}
 	}
@@ -1668,14 +2886,16 @@ void endShaderEditing(bool acceptCollectedShaderHashes, ToggleGroup& groupEditin
 {
 	if (acceptCollectedShaderHashes && g_toggleGroupIdShaderEditing == groupEditing.getId())
 	{
+		DeviceDataContainer& deviceData = getHuntingDeviceData();
 		groupEditing.storeCollectedHashes(
-			g_pixelShaderManager.getMarkedShaderHashes(),
-			g_vertexShaderManager.getMarkedShaderHashes(),
-			g_computeShaderManager.getMarkedShaderHashes());
-
-		g_pixelShaderManager.stopHuntingMode();
-		g_vertexShaderManager.stopHuntingMode();
-		g_computeShaderManager.stopHuntingMode();
+			deviceData.pixelShaderManager.getMarkedShaderHashes(),
+			deviceData.vertexShaderManager.getMarkedShaderHashes(),
+			deviceData.computeShaderManager.getMarkedShaderHashes());
+
+		deviceData.pixelShaderManager.stopHuntingMode();
+		deviceData.vertexShaderManager.stopHuntingMode();
+		deviceData.computeShaderManager.stopHuntingMode();
+		g_hotkeyDispatchDirty = true;
 	}
 	g_toggleGroupIdShaderEditing = -1;
 }
@@ -1691,11 +2911,29 @@ void startShaderEditing(ToggleGroup& groupEditing)
 		endShaderEditing(false, groupEditing);
 	}
 
+	DeviceDataContainer& deviceData = getHuntingDeviceData();
 	g_toggleGroupIdShaderEditing = groupEditing.getId();
 	g_activeCollectorFrameCounter = g_startValueFramecountCollectionPhase;
-	g_pixelShaderManager.startHuntingMode(groupEditing.getPixelShaderHashes());
-	g_vertexShaderManager.startHuntingMode(groupEditing.getVertexShaderHashes());
-	g_computeShaderManager.startHuntingMode(groupEditing.getComputeShaderHashes());
+	deviceData.pixelShaderManager.startHuntingMode(groupEditing.getPixelShaderHashes());
+	deviceData.vertexShaderManager.startHuntingMode(groupEditing.getVertexShaderHashes());
+	deviceData.computeShaderManager.startHuntingMode(groupEditing.getComputeShaderHashes());
+	g_hotkeyDispatchDirty = true;
+
+	if (g_backgroundSamplingEnabled)
+	{
+		const uint32_t frameEpoch = g_frameEpoch;
+		const uint32_t frameWindow = static_cast<uint32_t>(g_startValueFramecountCollectionPhase);
+		uint32_t amountSeeded = 0;
+		amountSeeded += deviceData.pixelShaderManager.seedCollectedFromRecentFrames(frameEpoch, frameWindow);
+		amountSeeded += deviceData.vertexShaderManager.seedCollectedFromRecentFrames(frameEpoch, frameWindow);
+		amountSeeded += deviceData.computeShaderManager.seedCollectedFromRecentFrames(frameEpoch, frameWindow);
+
+		// Only skip the collection phase when sampling actually saw something, e.g. not right after enabling it.
+		if (amountSeeded > 0)
+		{
+			g_activeCollectorFrameCounter = 0;
+		}
+	}
 
 	groupEditing.clearHashes();
 }
@@ -1713,27 +2951,105 @@ static void showHelpMarker(const char* desc)
 	}
 }
 
+static void displayShaderActivityHistory()
+{
+	if (!g_backgroundSamplingEnabled)
+	{
+		ImGui::TextWrapped("Enable 'Background shader sampling' to record which shaders were active in the last %d frames.", SHADER_ACTIVITY_HISTORY_MAX_FRAMES);
+		return;
+	}
+
+	if (g_pixelShaderActivityHistory.isEmpty())
+	{
+		ImGui::TextUnformatted("No frames recorded yet.");
+		return;
+	}
+
+	const uint32_t newestFrame = g_pixelShaderActivityHistory.getNewestFrame();
+	const int recordedFrames = static_cast<int>(newestFrame - g_pixelShaderActivityHistory.getOldestFrame()) + 1;
+	const size_t memoryUsage = g_pixelShaderActivityHistory.getMemoryUsage() + g_vertexShaderActivityHistory.getMemoryUsage() + g_computeShaderActivityHistory.getMemoryUsage();
+	ImGui::Text("Recorded frames: %d (%u distinct), %.1f KB", recordedFrames, g_pixelShaderActivityHistory.getRecordCount(), static_cast<float>(memoryUsage) / 1024.0f);
+
+	bool frozen = g_pixelShaderActivityHistory.isFrozen();
+	if (ImGui::Checkbox("Freeze history", &frozen))
+	{
+		g_pixelShaderActivityHistory.setFrozen(frozen);
+		g_vertexShaderActivityHistory.setFrozen(frozen);
+		g_computeShaderActivityHistory.setFrozen(frozen);
+	}
+	ImGui::SameLine();
+	showHelpMarker("Stops recording so the frames around a glitch stay available while you look at them.");
+
+	ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.5f);
+	ImGui::SliderInt("Frame (frames ago)", &g_shaderActivityFramesAgo, 0, std::max(recordedFrames - 2, 0));
+	ImGui::SliderInt("Compare with (frames earlier)", &g_shaderActivityCompareFrames, 1, std::max(recordedFrames - 1, 1));
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	showHelpMarker("Lists the shaders that were active in the selected frame but not in the frame this many frames before it.");
+
+	const uint32_t frame = newestFrame - static_cast<uint32_t>(g_shaderActivityFramesAgo);
+	const uint32_t baselineFrame = frame - static_cast<uint32_t>(g_shaderActivityCompareFrames);
+
+	static std::vector<uint32_t> pixelActivated;
+	static std::vector<uint32_t> vertexActivated;
+	static std::vector<uint32_t> computeActivated;
+	const bool inRange =
+		g_pixelShaderActivityHistory.collectActivatedBetween(frame, baselineFrame, pixelActivated) &&
+		g_vertexShaderActivityHistory.collectActivatedBetween(frame, baselineFrame, vertexActivated) &&
+		g_computeShaderActivityHistory.collectActivatedBetween(frame, baselineFrame, computeActivated);
+	if (!inRange)
+	{
+		ImGui::TextUnformatted("The compared frame is no longer recorded.");
+		return;
+	}
+
+	ImGui::Text("Newly active: %u pixel, %u vertex, %u compute shaders",
+		static_cast<uint32_t>(pixelActivated.size()), static_cast<uint32_t>(vertexActivated.size()), static_cast<uint32_t>(computeActivated.size()));
+
+	if (g_toggleGroupIdShaderEditing < 0)
+	{
+		ImGui::TextDisabled("Click Hunt Shaders on a group to hunt through these shaders.");
+		return;
+	}
+
+	if (ImGui::Button("Hunt these shaders"))
+	{
+		DeviceDataContainer& deviceData = getHuntingDeviceData();
+		deviceData.pixelShaderManager.replaceCollectedFromDenseIndices(pixelActivated);
+		deviceData.vertexShaderManager.replaceCollectedFromDenseIndices(vertexActivated);
+		deviceData.computeShaderManager.replaceCollectedFromDenseIndices(computeActivated);
+		g_activeCollectorFrameCounter = 0;
+	}
+}
+
 static void displaySettings(reshade::api::effect_runtime* runtime)
 {
 	applyModernUiStyle();
 
+	// group settings and timers can change anywhere below, so don't rely on the scheduled deadlines this frame.
+	g_groupFullUpdatePending = true;
+
 	if (ImGui::CollapsingHeader("General info and help"))
 	{
 		ImGui::PushTextWrapPos();
 		ImGui::TextUnformatted("Create groups, assign hotkeys, hunt shaders, and toggle them in-game.");
 		ImGui::TextUnformatted("");
 		ImGui::TextUnformatted("Hunting hotkeys:");
-		ImGui::TextUnformatted("* Numpad 1 / 2 = previous / next pixel shader");
-		ImGui::TextUnformatted("* Ctrl + Numpad 1 / 2 = previous / next marked pixel shader");
-		ImGui::TextUnformatted("* Numpad 3 = mark / unmark pixel shader");
-		ImGui::TextUnformatted("* Numpad 4 / 5 = previous / next vertex shader");
-		ImGui::TextUnformatted("* Ctrl + Numpad 4 / 5 = previous / next marked vertex shader");
-		ImGui::TextUnformatted("* Numpad 6 = mark / unmark vertex shader");
-		ImGui::TextUnformatted("* Numpad 7 / 8 = previous / next compute shader");
-		ImGui::TextUnformatted("* Ctrl + Numpad 7 / 8 = previous / next marked compute shader");
-		ImGui::TextUnformatted("* Numpad 9 = mark / unmark compute shader");
-		ImGui::TextUnformatted("* Hold 1 / 2 / 4 / 5 / 7 / 8 to scroll faster");
+		for (int i = 0; i + 2 < g_huntingNavigationKeyCount; i += 3)
+		{
+			const char* previousKey = g_huntingNavigationKeyNames[i].c_str();
+			const char* nextKey = g_huntingNavigationKeyNames[i + 1].c_str();
+			const char* stageName = g_huntingNavigationBindings[i].stageName;
+			ImGui::Text("* %s / %s = previous / next %s shader", previousKey, nextKey, stageName);
+			ImGui::Text("* Ctrl + %s / %s = previous / next marked %s shader", previousKey, nextKey, stageName);
+			ImGui::Text("* %s = mark / unmark %s shader", g_huntingNavigationKeyNames[i + 2].c_str(), stageName);
+		}
+		ImGui::TextUnformatted("* Hold previous / next to scroll faster");
 		ImGui::PopTextWrapPos();
+
+		const ConfigPersistenceWorker::Stats saveStats = g_configPersistence.getStats();
+		ImGui::TextDisabled("Config saves: %u written, %u coalesced, last queued %.0f ms, last write %.1f ms (max %.1f ms)",
+			saveStats.writes, saveStats.snapshotsCoalesced, saveStats.lastQueueLatencyMs, saveStats.lastWriteMs, saveStats.maxWriteMs);
 	}
 
 	if (ImGui::CollapsingHeader("Shader selection parameters", ImGuiTreeNodeFlags_DefaultOpen))
@@ -1748,6 +3064,36 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		ImGui::SameLine();
 		showHelpMarker("Increase this if the shader you want only appears occasionally.");
 
+		bool backgroundSampling = g_backgroundSamplingEnabled;
+		if (ImGui::Checkbox("Background shader sampling", &backgroundSampling))
+		{
+			g_backgroundSamplingEnabled = backgroundSampling;
+			saveShaderTogglerIniFile();
+		}
+		ImGui::SameLine();
+		showHelpMarker("Keeps track of the shaders used in recent frames at all times, so Hunt Shaders starts immediately with the shaders of the last '# of frames to collect' frames instead of collecting first.");
+
+		if (g_backgroundSamplingEnabled)
+		{
+			ImGui::Text("Sampling every %u frame(s), ~%.0f ns per bind (budget %d ns)",
+				g_backgroundSamplingFrameInterval.load(), g_backgroundSamplingAverageNs, BACKGROUND_SAMPLING_BUDGET_NS);
+		}
+
+		int huntCandidateFilter = static_cast<int>(g_huntCandidateFilter);
+		const char* huntCandidateFilterItems[] = {
+			"All shaders",
+			"HUD-like (alpha blended, no depth test)",
+			"Geometry (writes depth)",
+			"Depth only (no render targets)"
+		};
+		if (ImGui::Combo("Hunting candidates", &huntCandidateFilter, huntCandidateFilterItems, IM_ARRAYSIZE(huntCandidateFilterItems)))
+		{
+			setHuntCandidateFilter(static_cast<HuntCandidateFilter>(huntCandidateFilter));
+			saveShaderTogglerIniFile();
+		}
+		ImGui::SameLine();
+		showHelpMarker("Only collects shaders whose pipeline state matches, which can shrink the list to go through a lot. Start Hunt Shaders again after changing it. Only D3D12 and Vulkan report this state; with other APIs all shaders are collected.");
+
 		int controllerMode = static_cast<int>(KeyData::getControllerLabelMode());
 		const char* controllerModeItems[] = { "Auto", "Xbox", "PlayStation" };
 		if (ImGui::Combo("Controller labels", &controllerMode, controllerModeItems, IM_ARRAYSIZE(controllerModeItems)))
@@ -1758,6 +3104,34 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		ImGui::SameLine();
 		showHelpMarker("Changes how gamepad buttons are shown in hotkey text. Auto tries to detect PlayStation controllers.");
 
+		bool gamepadPollingThread = KeyData::isGamepadPollingThreadEnabled();
+		int gamepadPollingInterval = static_cast<int>(KeyData::getGamepadPollingIntervalMs());
+		bool gamepadPollingChanged = ImGui::Checkbox("Poll controller in background", &gamepadPollingThread);
+		ImGui::SameLine();
+		showHelpMarker("Reads the controller on a separate thread instead of every frame, so controller polling doesn't add to frame time and short button taps between two frames aren't missed. Only starts once a controller button is used as hotkey.");
+		if (gamepadPollingThread)
+		{
+			gamepadPollingChanged |= ImGui::SliderInt("Controller polling interval (ms)", &gamepadPollingInterval, 1, GAMEPAD_POLLING_INTERVAL_MS_MAX);
+		}
+		if (gamepadPollingChanged)
+		{
+			KeyData::setGamepadPollingThread(gamepadPollingThread, static_cast<uint32_t>(gamepadPollingInterval));
+			saveShaderTogglerIniFile();
+		}
+
+		if (ImGui::Checkbox("Binary config cache", &g_configCacheEnabled))
+		{
+			if (!g_configCacheEnabled)
+				ConfigCache::remove(g_iniFileName);
+			saveShaderTogglerIniFile();
+		}
+		ImGui::SameLine();
+		showHelpMarker("Keeps a binary copy of ShaderToggler.ini (ShaderToggler.stcache) that loads without parsing text, which speeds up game start with very large configs. It is only used while the .ini is unchanged; otherwise the .ini is loaded and the cache rebuilt.");
+		if (g_configLoadedFromCache)
+		{
+			ImGui::TextDisabled("Loaded from the binary config cache at startup");
+		}
+
 		if (KeyData::getControllerLabelMode() == KeyData::ControllerLabelMode::Auto)
 		{
 			KeyData::refreshControllerTypeDetection();
@@ -1804,6 +3178,12 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 	}
 	ImGui::Separator();
 
+	if (ImGui::CollapsingHeader("Shader activity history"))
+	{
+		displayShaderActivityHistory();
+	}
+	ImGui::Separator();
+
 	if (ImGui::CollapsingHeader("Suspend All Toggle Groups", ImGuiTreeNodeFlags_DefaultOpen))
 	{
 		ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.00f, 0.78f, 0.25f, 1.00f));
@@ -1813,7 +3193,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		if (ImGui::Button("Set Current State as Gameplay"))
 		{
 			if (g_allToggleGroupsSuspended)
-				restoreAllToggleGroups();
+				restoreAllToggleGroups(g_frameClock.now);
 
 			g_pendingSuspendedGroupToggles.clear();
 			g_globalSuspensionStarted = {};
@@ -1837,7 +3217,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		if (g_allToggleGroupsSuspended)
 		{
 			if (ImGui::Button("Restore Toggle Groups"))
-				restoreAllToggleGroups();
+				restoreAllToggleGroups(g_frameClock.now);
 
 			if (!g_pendingSuspendedGroupToggles.empty())
 			{
@@ -1894,6 +3274,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 						{
 							hotkeys.erase(
 								hotkeys.begin() + static_cast<std::ptrdiff_t>(hotkeyIndex));
+							g_hotkeyDispatchDirty = true;
 							saveShaderTogglerIniFile();
 							ImGui::PopID();
 							break;
@@ -1953,12 +3334,13 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 			{
 				g_globalSuspendHotkeys.clear();
 				g_globalRestoreHotkeys.clear();
+				g_hotkeyDispatchDirty = true;
 				g_globalSuspendHotkeySlotEditing = -1;
 				g_globalRestoreHotkeySlotEditing = -1;
 				g_keyCollector.clear();
 
 				if (g_allToggleGroupsSuspended)
-					restoreAllToggleGroups();
+					restoreAllToggleGroups(g_frameClock.now);
 
 				saveShaderTogglerIniFile();
 			}
@@ -1999,6 +3381,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 			if (ImGui::Button("Duplicate"))
 			{
 				g_toggleGroups.push_back(group.makeDuplicate());
+				syncGroupRuntimeStates();
 				saveShaderTogglerIniFile();
 			}
 
@@ -2051,7 +3434,8 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 				ImGui::Text(group.isTimedModeInverted() ? " Auto-show " : " Auto-hide ");
 				ImGui::PopStyleColor();
 
-				if (g_groupTimedFadeOutStart.find(group.getId()) != g_groupTimedFadeOutStart.end())
+				const GroupRuntimeState* runtimeState = findGroupRuntimeState(group);
+				if (runtimeState != nullptr && runtimeState->timedFadeOutStart)
 				{
 					ImGui::SameLine();
 					ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.65f, 0.30f, 1.0f));
@@ -2462,8 +3846,10 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 					ImGui::Text(" ");
 					ImGui::SameLine(ImGui::GetWindowWidth() * 0.25f);
 					bool holdInverted = group.isHoldInverted();
-					ImGui::Checkbox("Invert hold behavior", &holdInverted);
-					group.setHoldInverted(holdInverted);
+					if (ImGui::Checkbox("Invert hold behavior", &holdInverted))
+					{
+						group.setHoldInverted(holdInverted);
+					}
 					ImGui::SameLine();
 					showHelpMarker("When enabled, the group is active normally and turns off only while the hotkey is held.");
 					ImGui::PopItemWidth();
@@ -2559,9 +3945,11 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 			g_toggleGroupTimedSuppressionKeySlotEditing = -1;
 			g_keyCollector.clear();
 			g_toggleGroupIdShaderEditing = -1;
-			g_pixelShaderManager.stopHuntingMode();
-			g_vertexShaderManager.stopHuntingMode();
-			g_computeShaderManager.stopHuntingMode();
+			DeviceDataContainer& deviceData = getHuntingDeviceData();
+			deviceData.pixelShaderManager.stopHuntingMode();
+			deviceData.vertexShaderManager.stopHuntingMode();
+			deviceData.computeShaderManager.stopHuntingMode();
+			g_hotkeyDispatchDirty = true;
 
 			g_toggleGroups.erase(
 				std::remove_if(g_toggleGroups.begin(), g_toggleGroups.end(),
@@ -2570,16 +3958,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 						return std::find(idsToRemove.begin(), idsToRemove.end(), g.getId()) != idsToRemove.end();
 					}),
 				g_toggleGroups.end());
-
-			for (int id : idsToRemove)
-			{
-				g_groupHotkeyWasDown.erase(id);
-				g_groupHotkeyLastToggleTime.erase(id);
-				g_groupLastTimedTriggerTime.erase(id);
-				g_groupTimedVisibleSince.erase(id);
-				g_groupTimedFadeOutStart.erase(id);
-				g_groupLastTimedSuppressionInputTime.erase(id);
-			}
+			syncGroupRuntimeStates();
 
 			saveShaderTogglerIniFile();
 		}
@@ -2594,6 +3973,42 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		}
 	}
 
+	if (ImGui::CollapsingHeader("Import Hash Pack"))
+	{
+		ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.5f);
+
+		ImGui::InputText("Pack file", g_hashPackImportPath, sizeof(g_hashPackImportPath));
+		ImGui::SameLine();
+		showHelpMarker("Another ShaderToggler.ini, or a pack file in the same layout. A path without a folder is taken from the add-on's folder.");
+
+		const char* importModeItems[] = { "Union", "Intersection", "Replace" };
+		ImGui::Combo("Merge mode", &g_hashPackImportMode, importModeItems, IM_ARRAYSIZE(importModeItems));
+		ImGui::SameLine();
+		showHelpMarker("Groups are matched by name, ignoring case. Union adds the pack's shaders to a group and adds the groups you don't have. Intersection keeps only the shaders a group shares with the pack. Replace takes the pack's shaders for a group and adds the groups you don't have.");
+
+		ImGui::PopItemWidth();
+
+		if (isAnyConfigEditorOpen())
+		{
+			ImGui::TextDisabled("Finish editing the key binding or shader selection to import.");
+		}
+		else if (g_hashPackImportPath[0] != '\0' && ImGui::Button("Import"))
+		{
+			const std::string pathText(g_hashPackImportPath);
+			const HashPackMergeMode mode = static_cast<HashPackMergeMode>(g_hashPackImportMode);
+			HashPackMergeReport report;
+			if (importHashPack(std::filesystem::path(std::u8string(pathText.begin(), pathText.end())), mode, report))
+				g_hashPackImportResult = std::string(HashPackMerge::getModeName(mode)) + ": " + report.toString();
+			else
+				g_hashPackImportResult = "The file could not be read or has no groups.";
+		}
+
+		if (!g_hashPackImportResult.empty())
+		{
+			ImGui::TextWrapped("%s", g_hashPackImportResult.c_str());
+		}
+	}
+
 	if (ImGui::CollapsingHeader("Group Order", ImGuiTreeNodeFlags_DefaultOpen))
 	{
 		ImGui::TextUnformatted("Drag and drop to reorder toggle groups");
@@ -2653,6 +4068,7 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 						g_toggleGroups.erase(g_toggleGroups.begin() + src);
 						if (src < i) i--;
 						g_toggleGroups.insert(g_toggleGroups.begin() + i, std::move(tmp));
+						syncGroupRuntimeStates();
 						saveShaderTogglerIniFile();
 					}
 				}
@@ -2710,8 +4126,8 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
 			g_iniFileName = HASH_FILE_NAME;
 		}
 
-		KeyData::refreshControllerTypeDetection();
-
+		reshade::register_event<reshade::addon_event::init_device>(onInitDevice);
+		reshade::register_event<reshade::addon_event::destroy_device>(onDestroyDevice);
 		reshade::register_event<reshade::addon_event::init_pipeline>(onInitPipeline);
 		reshade::register_event<reshade::addon_event::init_command_list>(onInitCommandList);
 		reshade::register_event<reshade::addon_event::destroy_command_list>(onDestroyCommandList);
@@ -2719,13 +4135,15 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
 		reshade::register_event<reshade::addon_event::destroy_pipeline>(onDestroyPipeline);
 		reshade::register_event<reshade::addon_event::reshade_overlay>(onReshadeOverlay);
 		reshade::register_event<reshade::addon_event::reshade_present>(onReshadePresent);
+		reshade::register_event<reshade::addon_event::destroy_effect_runtime>(onDestroyEffectRuntime);
 		reshade::register_event<reshade::addon_event::bind_pipeline>(onBindPipeline);
 		reshade::register_event<reshade::addon_event::draw>(onDraw);
 		reshade::register_event<reshade::addon_event::draw_indexed>(onDrawIndexed);
 		reshade::register_event<reshade::addon_event::draw_or_dispatch_indirect>(onDrawOrDispatchIndirect);
 		reshade::register_overlay(nullptr, &displaySettings);
 
-		loadShaderTogglerIniFile();
+		// file I/O, a possible repair save and XInput loading don't belong under the loader lock.
+		startDeferredInitThread();
 	}
 	break;
 
@@ -2734,8 +4152,15 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
 		g_pendingSuspendedGroupToggles.clear();
 		g_globalSuspensionStarted = {};
 		reshade::unregister_event<reshade::addon_event::reshade_present>(onReshadePresent);
+		reshade::unregister_event<reshade::addon_event::destroy_effect_runtime>(onDestroyEffectRuntime);
+		// under the loader lock: nothing here may wait for a thread. destroy_effect_runtime stopped the save and
+		// controller threads before ReShade could unload the add-on, and ExitProcess has already ended them; the
+		// controller poller's destructor only detaches its thread.
+		g_configPersistence.abandon();
 		reshade::unregister_event<reshade::addon_event::destroy_pipeline>(onDestroyPipeline);
 		reshade::unregister_event<reshade::addon_event::init_pipeline>(onInitPipeline);
+		reshade::unregister_event<reshade::addon_event::init_device>(onInitDevice);
+		reshade::unregister_event<reshade::addon_event::destroy_device>(onDestroyDevice);
 		reshade::unregister_event<reshade::addon_event::reshade_overlay>(onReshadeOverlay);
 		reshade::unregister_event<reshade::addon_event::bind_pipeline>(onBindPipeline);
 		reshade::unregister_event<reshade::addon_event::draw>(onDraw);
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <reshade_api_pipeline.hpp>
+
+namespace ShaderToggler
+{
+	// Which shaders hunting collects. 'All' keeps the classic behavior.
+	enum class HuntCandidateFilter : uint8_t
+	{
+		All = 0,
+		HudLike = 1,		// alpha blended, no depth test
+		Geometry = 2,		// depth test and depth write
+		DepthOnly = 3,		// writes depth, no render targets (e.g. shadow maps)
+	};
+
+	// Packed output-merger state of a pipeline, captured in init_pipeline. 8 bytes so it can live
+	// next to the shader hash of every pipeline without blowing up memory on games with 100k pipelines.
+	struct PipelineStateInfo
+	{
+		enum : uint8_t
+		{
+			HasBlendState = 1 << 0,
+			HasDepthStencilState = 1 << 1,
+			HasRenderTargetFormats = 1 << 2,
+			BlendEnabled = 1 << 3,
+			DepthTestEnabled = 1 << 4,
+			DepthWriteEnabled = 1 << 5,
+		};
+
+		uint8_t flags = 0;
+		uint8_t topology = 0;
+		uint8_t renderTargetCount = 0;
+		uint8_t reserved = 0;
+		uint32_t firstRenderTargetFormat = 0;
+
+		static PipelineStateInfo fromSubobjects(uint32_t subobjectCount, const reshade::api::pipeline_subobject* subobjects)
+		{
+			using namespace reshade::api;
+
+			PipelineStateInfo info;
+			for (uint32_t i = 0; i < subobjectCount; ++i)
+			{
+				const pipeline_subobject& subobject = subobjects[i];
+				// Depth-only pipelines report an empty render target format list, so only that one may come without data.
+				if (subobject.data == nullptr && subobject.type != pipeline_subobject_type::render_target_formats)
+				{
+					continue;
+				}
+
+				switch (subobject.type)
+				{
+				case pipeline_subobject_type::blend_state:
+				{
+					const blend_desc& desc = *static_cast<const blend_desc*>(subobject.data);
+					info.flags |= HasBlendState;
+					for (const bool enabled : desc.blend_enable)
+					{
+						if (enabled)
+						{
+							info.flags |= BlendEnabled;
+							break;
+						}
+					}
+					break;
+				}
+				case pipeline_subobject_type::depth_stencil_state:
+				{
+					const depth_stencil_desc& desc = *static_cast<const depth_stencil_desc*>(subobject.data);
+					info.flags |= HasDepthStencilState;
+					if (desc.depth_enable)
+					{
+						info.flags |= DepthTestEnabled;
+						if (desc.depth_write_mask)
+						{
+							info.flags |= DepthWriteEnabled;
+						}
+					}
+					break;
+				}
+				case pipeline_subobject_type::primitive_topology:
+					info.topology = static_cast<uint8_t>(*static_cast<const primitive_topology*>(subobject.data));
+					break;
+				case pipeline_subobject_type::render_target_formats:
+					info.flags |= HasRenderTargetFormats;
+					info.renderTargetCount = static_cast<uint8_t>(subobject.count);
+					if (subobject.count > 0 && subobject.data != nullptr)
+					{
+						info.firstRenderTargetFormat = static_cast<uint32_t>(*static_cast<const format*>(subobject.data));
+					}
+					break;
+				default:
+					break;
+				}
+			}
+
+			return info;
+		}
+
+		// Bit (1 << filter) is set for every HuntCandidateFilter this pipeline passes. Pipelines without
+		// output-merger state (D3D9-11 create one pipeline per shader, state is bound separately) pass all filters.
+		uint8_t getMatchingHuntFilters() const
+		{
+			if ((flags & (HasBlendState | HasDepthStencilState)) == 0)
+			{
+				return 0xFF;
+			}
+
+			const bool blended = (flags & BlendEnabled) != 0;
+			const bool depthTest = (flags & DepthTestEnabled) != 0;
+			const bool depthWrite = (flags & DepthWriteEnabled) != 0;
+			const bool noRenderTargets = (flags & HasRenderTargetFormats) != 0 && renderTargetCount == 0;
+
+			uint8_t matching = 1 << static_cast<uint8_t>(HuntCandidateFilter::All);
+			if (blended && !depthTest)
+			{
+				matching |= 1 << static_cast<uint8_t>(HuntCandidateFilter::HudLike);
+			}
+			if (depthTest && depthWrite)
+			{
+				matching |= 1 << static_cast<uint8_t>(HuntCandidateFilter::Geometry);
+			}
+			if (depthWrite && noRenderTargets)
+			{
+				matching |= 1 << static_cast<uint8_t>(HuntCandidateFilter::DepthOnly);
+			}
+			return matching;
+		}
+	};
+	static_assert(sizeof(PipelineStateInfo) == 8, "PipelineStateInfo is stored per pipeline and should stay packed");
+}
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include "ShaderActivityHistory.h"
+
+namespace ShaderToggler
+{
+	ShaderActivityHistory::ShaderActivityHistory(uint32_t maxFrames, size_t maxMemoryBytes) :
+		_maxFrames(std::max<uint32_t>(maxFrames, 1)), _maxMemoryBytes(maxMemoryBytes)
+	{
+	}
+
+	void ShaderActivityHistory::commitFrame(uint32_t frameEpoch, const std::vector<uint64_t>& activeBits)
+	{
+		if (_frozen)
+		{
+			return;
+		}
+
+		if (_recordCapacity == 0 || activeBits.size() > _wordsPerFrame)
+		{
+			resizeForWordsPerFrame(activeBits.size());
+		}
+
+		if (_recordCount > 0)
+		{
+			FrameRecord& newest = _records[getNewestSlot()];
+			if (newest.lastFrame == frameEpoch)
+			{
+				return;
+			}
+
+			if (newestRecordEquals(activeBits))
+			{
+				newest.lastFrame = frameEpoch;
+				evictFramesOutsideWindow();
+				return;
+			}
+		}
+
+		if (_recordCount == _recordCapacity)
+		{
+			_oldestSlot = (_oldestSlot + 1) % _recordCapacity;
+			--_recordCount;
+		}
+
+		const uint32_t slot = (_oldestSlot + _recordCount) % _recordCapacity;
+		uint64_t* words = getRecordWords(slot);
+		std::copy(activeBits.begin(), activeBits.end(), words);
+		std::fill(words + activeBits.size(), words + _wordsPerFrame, 0);
+		_records[slot] = { frameEpoch, frameEpoch };
+		++_recordCount;
+
+		evictFramesOutsideWindow();
+	}
+
+	void ShaderActivityHistory::clear()
+	{
+		_oldestSlot = 0;
+		_recordCount = 0;
+	}
+
+	bool ShaderActivityHistory::collectActivatedBetween(uint32_t frame, uint32_t baselineFrame, std::vector<uint32_t>& denseIndices) const
+	{
+		denseIndices.clear();
+
+		const int slot = findRecordSlot(frame);
+		const int baselineSlot = findRecordSlot(baselineFrame);
+		if (slot < 0 || baselineSlot < 0)
+		{
+			return false;
+		}
+
+		const uint64_t* words = getRecordWords(static_cast<uint32_t>(slot));
+		const uint64_t* baselineWords = getRecordWords(static_cast<uint32_t>(baselineSlot));
+		for (size_t wordIndex = 0; wordIndex < _wordsPerFrame; ++wordIndex)
+		{
+			uint64_t activated = words[wordIndex] & ~baselineWords[wordIndex];
+			while (activated != 0)
+			{
+				denseIndices.push_back(static_cast<uint32_t>(wordIndex * 64 + std::countr_zero(activated)));
+				activated &= activated - 1;
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t ShaderActivityHistory::getOldestFrame() const
+	{
+		return _recordCount == 0 ? 0 : _records[_oldestSlot].firstFrame;
+	}
+
+	uint32_t ShaderActivityHistory::getNewestFrame() const
+	{
+		return _recordCount == 0 ? 0 : _records[getNewestSlot()].lastFrame;
+	}
+
+	size_t ShaderActivityHistory::getMemoryUsage() const
+	{
+		return _words.capacity() * sizeof(uint64_t) + _records.capacity() * sizeof(FrameRecord);
+	}
+
+	void ShaderActivityHistory::resizeForWordsPerFrame(size_t wordsPerFrame)
+	{
+		// Grow geometrically so a game streaming in shaders doesn't reallocate the ring every few frames.
+		size_t newWordsPerFrame = std::max<size_t>(_wordsPerFrame * 2, 16);
+		while (newWordsPerFrame < wordsPerFrame)
+		{
+			newWordsPerFrame *= 2;
+		}
+
+		const size_t bytesPerRecord = newWordsPerFrame * sizeof(uint64_t) + sizeof(FrameRecord);
+		const uint32_t newRecordCapacity = static_cast<uint32_t>(std::clamp<size_t>(_maxMemoryBytes / bytesPerRecord, 1, _maxFrames));
+
+		std::vector<FrameRecord> newRecords(newRecordCapacity);
+		std::vector<uint64_t> newWords(static_cast<size_t>(newRecordCapacity) * newWordsPerFrame, 0);
+
+		// Keep the newest records that still fit, widened with zero bits for the new shaders.
+		const uint32_t amountToKeep = std::min(_recordCount, newRecordCapacity);
+		for (uint32_t i = 0; i < amountToKeep; ++i)
+		{
+			const uint32_t sourceSlot = (_oldestSlot + _recordCount - amountToKeep + i) % _recordCapacity;
+			newRecords[i] = _records[sourceSlot];
+			const uint64_t* sourceWords = getRecordWords(sourceSlot);
+			std::copy(sourceWords, sourceWords + _wordsPerFrame, newWords.data() + static_cast<size_t>(i) * newWordsPerFrame);
+		}
+
+		_records = std::move(newRecords);
+		_words = std::move(newWords);
+		_wordsPerFrame = newWordsPerFrame;
+		_recordCapacity = newRecordCapacity;
+		_oldestSlot = 0;
+		_recordCount = amountToKeep;
+	}
+
+	void ShaderActivityHistory::evictFramesOutsideWindow()
+	{
+		const uint32_t newestFrame = getNewestFrame();
+
+		while (_recordCount > 1 && newestFrame - _records[_oldestSlot].lastFrame >= _maxFrames)
+		{
+			_oldestSlot = (_oldestSlot + 1) % _recordCapacity;
+			--_recordCount;
+		}
+
+		FrameRecord& oldest = _records[_oldestSlot];
+		if (newestFrame - oldest.firstFrame >= _maxFrames)
+		{
+			oldest.firstFrame = newestFrame - (_maxFrames - 1);
+		}
+	}
+
+	int ShaderActivityHistory::findRecordSlot(uint32_t frame) const
+	{
+		if (_recordCount == 0)
+		{
+			return -1;
+		}
+
+		// Ages are relative to the newest frame so the lookup keeps working when the epoch wraps.
+		const uint32_t newestFrame = getNewestFrame();
+		const uint32_t age = newestFrame - frame;
+		if (age > newestFrame - _records[_oldestSlot].firstFrame)
+		{
+			return -1;
+		}
+
+		for (uint32_t i = _recordCount; i > 0; --i)
+		{
+			const uint32_t slot = (_oldestSlot + i - 1) % _recordCapacity;
+			if (newestFrame - _records[slot].firstFrame >= age)
+			{
+				return static_cast<int>(slot);
+			}
+		}
+
+		return -1;
+	}
+
+	bool ShaderActivityHistory::newestRecordEquals(const std::vector<uint64_t>& activeBits) const
+	{
+		const uint64_t* words = getRecordWords(getNewestSlot());
+		for (size_t wordIndex = 0; wordIndex < _wordsPerFrame; ++wordIndex)
+		{
+			const uint64_t activeWord = wordIndex < activeBits.size() ? activeBits[wordIndex] : 0;
+			if (words[wordIndex] != activeWord)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
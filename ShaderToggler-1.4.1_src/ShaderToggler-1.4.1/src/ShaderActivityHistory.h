@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ShaderToggler
+{
+	// Bounded history of the shaders (by dense index, see ShaderManager) that were active per sampled frame.
+	// Frames are kept as fixed-width bitsets in a ring that is only reallocated when the shader count
+	// outgrows it; consecutive identical frames share a single record (run-length encoded).
+	// Not thread safe, only used from the present thread.
+	class ShaderActivityHistory
+	{
+	public:
+		ShaderActivityHistory(uint32_t maxFrames, size_t maxMemoryBytes);
+
+		void commitFrame(uint32_t frameEpoch, const std::vector<uint64_t>& activeBits);
+		void clear();
+
+		// Dense indices active in the recorded frame covering 'frame' but not in the one covering 'baselineFrame'.
+		// Returns false if either frame is outside the recorded range.
+		bool collectActivatedBetween(uint32_t frame, uint32_t baselineFrame, std::vector<uint32_t>& denseIndices) const;
+
+		bool isFrozen() const { return _frozen; }
+		void setFrozen(bool frozen) { _frozen = frozen; }
+
+		bool isEmpty() const { return _recordCount == 0; }
+		uint32_t getRecordCount() const { return _recordCount; }
+		uint32_t getRecordCapacity() const { return _recordCapacity; }
+		uint32_t getOldestFrame() const;
+		uint32_t getNewestFrame() const;
+		size_t getMemoryUsage() const;
+
+	private:
+		struct FrameRecord
+		{
+			uint32_t firstFrame;
+			uint32_t lastFrame;
+		};
+
+		void resizeForWordsPerFrame(size_t wordsPerFrame);
+		void evictFramesOutsideWindow();
+		int findRecordSlot(uint32_t frame) const;
+		bool newestRecordEquals(const std::vector<uint64_t>& activeBits) const;
+		const uint64_t* getRecordWords(uint32_t slot) const { return _words.data() + static_cast<size_t>(slot) * _wordsPerFrame; }
+		uint64_t* getRecordWords(uint32_t slot) { return _words.data() + static_cast<size_t>(slot) * _wordsPerFrame; }
+		uint32_t getNewestSlot() const { return (_oldestSlot + _recordCount - 1) % _recordCapacity; }
+
+		uint32_t _maxFrames;
+		size_t _maxMemoryBytes;
+		size_t _wordsPerFrame = 0;
+		uint32_t _recordCapacity = 0;
+		uint32_t _oldestSlot = 0;
+		uint32_t _recordCount = 0;
+		std::vector<FrameRecord> _records;
+		std::vector<uint64_t> _words;
+		bool _frozen = false;
+	};
+}
@@ -45,64 +45,185 @@ namespace ShaderToggler
 	{
 	}
 
-	void ShaderManager::addHashHandlePair(uint32_t shaderHash, uint64_t pipelineHandle)
+	void ShaderManager::addHashHandlePair(uint32_t shaderHash, uint64_t pipelineHandle, const PipelineStateInfo& pipelineState)
 	{
 		if (pipelineHandle > 0 && shaderHash > 0)
 		{
 			std::unique_lock lock(_hashHandlesMutex);
-			_handleToShaderHash[pipelineHandle] = shaderHash;
-			_shaderHashes.emplace(shaderHash);
+
+			const PipelineEntry entry = { shaderHash, getOrAssignDenseIndexLocked(shaderHash), pipelineState };
+			_huntFilterMatchesByDenseIndex[entry.denseIndex] |= pipelineState.getMatchingHuntFilters();
+
+			const auto [it, inserted] = _handleToShaderHash.try_emplace(pipelineHandle, entry);
+			if (!inserted)
+			{
+				if (it->second.shaderHash == shaderHash)
+				{
+					it->second.state = pipelineState;
+					return;
+				}
+
+				// Handle reused for another shader without a destroy in between.
+				const auto countIt = _pipelineCountByShaderHash.find(it->second.shaderHash);
+				if (countIt != _pipelineCountByShaderHash.end() && --countIt->second == 0)
+				{
+					_pipelineCountByShaderHash.erase(countIt);
+				}
+				it->second = entry;
+			}
+
+			++_pipelineCountByShaderHash[shaderHash];
 		}
 	}
 
-	void ShaderManager::rebuildHuntSnapshotLocked()
+	uint32_t ShaderManager::getOrAssignDenseIndexLocked(uint32_t shaderHash)
 	{
-		_huntShaderHashesSnapshot = _collectedActiveShaderHashesOrdered;
+		const auto it = _shaderHashToDenseIndex.find(shaderHash);
+		if (it != _shaderHashToDenseIndex.end())
+		{
+			return it->second;
+		}
+
+		const uint32_t denseIndex = static_cast<uint32_t>(_denseIndexToShaderHash.size());
+		_shaderHashToDenseIndex.emplace(shaderHash, denseIndex);
+		_denseIndexToShaderHash.push_back(shaderHash);
+		_huntFilterMatchesByDenseIndex.push_back(0);
 
-		if (_huntShaderHashesSnapshot.empty())
+		if (denseIndex >= _lastSeenFrameCapacity)
+		{
+			const size_t newCapacity = _lastSeenFrameCapacity == 0 ? 1024 : _lastSeenFrameCapacity * 2;
+			std::unique_ptr<std::atomic_uint32_t[]> grown(new std::atomic_uint32_t[newCapacity]);
+			for (size_t i = 0; i < newCapacity; ++i)
+			{
+				grown[i].store(i < _lastSeenFrameCapacity ? _lastSeenFrameByDenseIndex[i].load(std::memory_order_relaxed) : 0, std::memory_order_relaxed);
+			}
+			_lastSeenFrameByDenseIndex = std::move(grown);
+			_lastSeenFrameCapacity = newCapacity;
+		}
+
+		return denseIndex;
+	}
+
+	bool ShaderManager::appendCollectedShaderHashLocked(uint32_t shaderHash)
+	{
+		const int position = static_cast<int>(_collectedActiveShaderHashesOrdered.size());
+		if (!_collectedPositionByShaderHash.try_emplace(shaderHash, position).second)
+		{
+			return false;
+		}
+
+		_collectedActiveShaderHashesOrdered.push_back(shaderHash);
+
+		std::shared_lock markedLock(_markedShaderHashMutex);
+		if (_markedShaderHashes.count(shaderHash) == 1)
+		{
+			_markedCollectedPositions.emplace_hint(_markedCollectedPositions.end(), position);
+		}
+
+		return true;
+	}
+
+	void ShaderManager::removeCollectedShaderHashLocked(uint32_t shaderHash)
+	{
+		const auto it = _collectedPositionByShaderHash.find(shaderHash);
+		if (it == _collectedPositionByShaderHash.end())
 		{
-			_activeHuntedShaderIndex = -1;
-			_activeHuntedShaderHash = 0;
 			return;
 		}
 
-		if (_activeHuntedShaderHash == 0)
+		// Leave a tombstone so the positions of all other collected shaders, and with that the
+		// current hunting position and the marked position index, stay valid.
+		const int position = it->second;
+		_collectedPositionByShaderHash.erase(it);
+		_collectedActiveShaderHashesOrdered[static_cast<size_t>(position)] = 0;
+		_markedCollectedPositions.erase(position);
+		++_collectedTombstoneCount;
+
+		if (_activeHuntedShaderHash == shaderHash)
 		{
+			_activeHuntedShaderHash = 0;
 			_activeHuntedShaderIndex = -1;
-			return;
 		}
 
-		for (size_t i = 0; i < _huntShaderHashesSnapshot.size(); ++i)
+		if (_collectedTombstoneCount >= 64 && _collectedTombstoneCount * 4 >= _collectedActiveShaderHashesOrdered.size())
 		{
-			if (_huntShaderHashesSnapshot[i] == _activeHuntedShaderHash)
+			compactCollectedLocked();
+		}
+	}
+
+	void ShaderManager::compactCollectedLocked()
+	{
+		int newActiveHuntedShaderIndex = -1;
+		size_t writePosition = 0;
+		for (size_t readPosition = 0; readPosition < _collectedActiveShaderHashesOrdered.size(); ++readPosition)
+		{
+			const uint32_t shaderHash = _collectedActiveShaderHashesOrdered[readPosition];
+			if (shaderHash == 0)
 			{
-				_activeHuntedShaderIndex = static_cast<int>(i);
-				return;
+				continue;
 			}
+
+			if (static_cast<int>(readPosition) == _activeHuntedShaderIndex)
+			{
+				newActiveHuntedShaderIndex = static_cast<int>(writePosition);
+			}
+
+			_collectedActiveShaderHashesOrdered[writePosition] = shaderHash;
+			_collectedPositionByShaderHash[shaderHash] = static_cast<int>(writePosition);
+			++writePosition;
 		}
 
-		_activeHuntedShaderIndex = -1;
-		_activeHuntedShaderHash = 0;
+		_collectedActiveShaderHashesOrdered.resize(writePosition);
+		_collectedTombstoneCount = 0;
+		_activeHuntedShaderIndex = newActiveHuntedShaderIndex;
+		rebuildMarkedCollectedPositionsLocked();
+	}
+
+	void ShaderManager::clearCollectedLocked()
+	{
+		_collectedActiveShaderHashesOrdered.clear();
+		_collectedPositionByShaderHash.clear();
+		_markedCollectedPositions.clear();
+		_collectedTombstoneCount = 0;
+	}
+
+	void ShaderManager::rebuildMarkedCollectedPositionsLocked()
+	{
+		std::shared_lock markedLock(_markedShaderHashMutex);
+
+		_markedCollectedPositions.clear();
+		if (_markedShaderHashes.empty())
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < _collectedActiveShaderHashesOrdered.size(); ++i)
+		{
+			const uint32_t shaderHash = _collectedActiveShaderHashesOrdered[i];
+			if (shaderHash != 0 && _markedShaderHashes.count(shaderHash) == 1)
+			{
+				_markedCollectedPositions.emplace_hint(_markedCollectedPositions.end(), static_cast<int>(i));
+			}
+		}
 	}
 
-	void ShaderManager::syncActiveHuntedShaderToSnapshotLocked()
+	void ShaderManager::syncActiveHuntedShaderToCollectedLocked()
 	{
 		if (_activeHuntedShaderIndex < 0 ||
-			_huntShaderHashesSnapshot.empty() ||
-			_activeHuntedShaderIndex >= static_cast<int>(_huntShaderHashesSnapshot.size()))
+			_activeHuntedShaderIndex >= static_cast<int>(_collectedActiveShaderHashesOrdered.size()))
 		{
 			_activeHuntedShaderIndex = -1;
 			_activeHuntedShaderHash = 0;
 			return;
 		}
 
-		_activeHuntedShaderHash = _huntShaderHashesSnapshot[static_cast<size_t>(_activeHuntedShaderIndex)];
+		_activeHuntedShaderHash = _collectedActiveShaderHashesOrdered[static_cast<size_t>(_activeHuntedShaderIndex)];
 	}
 
 	void ShaderManager::removeHandle(uint64_t handle)
 	{
 		uint32_t shaderHash = 0;
-		bool stillReferencedByAnotherHandle = false;
+		bool lastReferenceRemoved = false;
 
 		{
 			std::unique_lock lock(_hashHandlesMutex);
@@ -113,49 +234,21 @@ namespace ShaderToggler
 				return;
 			}
 
-			shaderHash = it->second;
+			shaderHash = it->second.shaderHash;
 			_handleToShaderHash.erase(it);
 
-			for (const auto& pair : _handleToShaderHash)
-			{
-				if (pair.second == shaderHash)
-				{
-					stillReferencedByAnotherHandle = true;
-					break;
-				}
-			}
-
-			if (!stillReferencedByAnotherHandle)
+			const auto countIt = _pipelineCountByShaderHash.find(shaderHash);
+			if (countIt != _pipelineCountByShaderHash.end() && --countIt->second == 0)
 			{
-				_shaderHashes.erase(shaderHash);
+				_pipelineCountByShaderHash.erase(countIt);
+				lastReferenceRemoved = true;
 			}
 		}
 
-		if (!stillReferencedByAnotherHandle && shaderHash > 0)
+		if (lastReferenceRemoved)
 		{
 			std::unique_lock collectedLock(_collectedActiveHandlesMutex);
-
-			_collectedActiveShaderHashes.erase(shaderHash);
-
-			for (auto it = _collectedActiveShaderHashesOrdered.begin(); it != _collectedActiveShaderHashesOrdered.end();)
-			{
-				if (*it == shaderHash)
-				{
-					it = _collectedActiveShaderHashesOrdered.erase(it);
-				}
-				else
-				{
-					++it;
-				}
-			}
-
-			if (_activeHuntedShaderHash == shaderHash)
-			{
-				_activeHuntedShaderHash = 0;
-				_activeHuntedShaderIndex = -1;
-			}
-
-			rebuildHuntSnapshotLocked();
+			removeCollectedShaderHashLocked(shaderHash);
 		}
 	}
 
@@ -176,9 +269,7 @@ namespace ShaderToggler
 
 		{
 			std::unique_lock lock(_collectedActiveHandlesMutex);
-			_collectedActiveShaderHashes.clear();
-			_collectedActiveShaderHashesOrdered.clear();
-			_huntShaderHashesSnapshot.clear();
+			clearCollectedLocked();
 		}
 	}
 
@@ -195,7 +286,7 @@ namespace ShaderToggler
 
 		{
 			std::unique_lock lock(_collectedActiveHandlesMutex);
-			_huntShaderHashesSnapshot.clear();
+			_markedCollectedPositions.clear();
 		}
 	}
 
@@ -204,14 +295,13 @@ namespace ShaderToggler
 		std::shared_lock lock(_collectedActiveHandlesMutex);
 
 		if (_activeHuntedShaderIndex < 0 ||
-			_huntShaderHashesSnapshot.empty() ||
-			_activeHuntedShaderIndex >= static_cast<int>(_huntShaderHashesSnapshot.size()))
+			_activeHuntedShaderIndex >= static_cast<int>(_collectedActiveShaderHashesOrdered.size()))
 		{
 			_activeHuntedShaderHash = 0;
 			return;
 		}
 
-		_activeHuntedShaderHash = _huntShaderHashesSnapshot[static_cast<size_t>(_activeHuntedShaderIndex)];
+		_activeHuntedShaderHash = _collectedActiveShaderHashesOrdered[static_cast<size_t>(_activeHuntedShaderIndex)];
 	}
 
 	void ShaderManager::huntNextShader(bool ctrlPressed)
@@ -223,24 +313,17 @@ namespace ShaderToggler
 
 		std::unique_lock collectedLock(_collectedActiveHandlesMutex);
 
-		if (_huntShaderHashesSnapshot.empty())
-		{
-			rebuildHuntSnapshotLocked();
-		}
-
-		if (_huntShaderHashesSnapshot.empty())
+		if (_collectedPositionByShaderHash.empty())
 		{
 			return;
 		}
 
-		const int collectedCount = static_cast<int>(_huntShaderHashesSnapshot.size());
+		const int collectedCount = static_cast<int>(_collectedActiveShaderHashesOrdered.size());
 
 		if (ctrlPressed)
 		{
-			std::shared_lock markedLock(_markedShaderHashMutex);
-
-			if (_markedShaderHashes.empty() ||
-				(_markedShaderHashes.size() == 1 && _markedShaderHashes.count(_activeHuntedShaderHash) == 1))
+			if (_markedCollectedPositions.empty() ||
+				(_markedCollectedPositions.size() == 1 && *_markedCollectedPositions.begin() == _activeHuntedShaderIndex))
 			{
 				return;
 			}
@@ -251,32 +334,26 @@ namespace ShaderToggler
 				startIndex = -1;
 			}
 
-			int index = startIndex;
-			for (int step = 0; step < collectedCount; ++step)
+			auto next = _markedCollectedPositions.upper_bound(startIndex);
+			if (next == _markedCollectedPositions.end())
 			{
-				index = (index + 1) % collectedCount;
-				const uint32_t hash = _huntShaderHashesSnapshot[static_cast<size_t>(index)];
-				if (_markedShaderHashes.count(hash) == 1)
-				{
-					_activeHuntedShaderIndex = index;
-					_activeHuntedShaderHash = hash;
-					return;
-				}
+				next = _markedCollectedPositions.begin();
 			}
 
+			_activeHuntedShaderIndex = *next;
+			_activeHuntedShaderHash = _collectedActiveShaderHashesOrdered[static_cast<size_t>(*next)];
 			return;
 		}
 
-		if (_activeHuntedShaderIndex < collectedCount - 1)
-		{
-			_activeHuntedShaderIndex++;
-		}
-		else
+		// Tombstones are skipped; compaction keeps them to a fraction of the list.
+		int index = _activeHuntedShaderIndex;
+		do
 		{
-			_activeHuntedShaderIndex = 0;
-		}
+			index = (index >= 0 && index < collectedCount - 1) ? index + 1 : 0;
+		} while (_collectedActiveShaderHashesOrdered[static_cast<size_t>(index)] == 0);
 
-		syncActiveHuntedShaderToSnapshotLocked();
+		_activeHuntedShaderIndex = index;
+		syncActiveHuntedShaderToCollectedLocked();
 	}
 
 	void ShaderManager::huntPreviousShader(bool ctrlPressed)
@@ -288,24 +365,17 @@ namespace ShaderToggler
 
 		std::unique_lock collectedLock(_collectedActiveHandlesMutex);
 
-		if (_huntShaderHashesSnapshot.empty())
-		{
-			rebuildHuntSnapshotLocked();
-		}
-
-		if (_huntShaderHashesSnapshot.empty())
+		if (_collectedPositionByShaderHash.empty())
 		{
 			return;
 		}
 
-		const int collectedCount = static_cast<int>(_huntShaderHashesSnapshot.size());
+		const int collectedCount = static_cast<int>(_collectedActiveShaderHashesOrdered.size());
 
 		if (ctrlPressed)
 		{
-			std::shared_lock markedLock(_markedShaderHashMutex);
-
-			if (_markedShaderHashes.empty() ||
-				(_markedShaderHashes.size() == 1 && _markedShaderHashes.count(_activeHuntedShaderHash) == 1))
+			if (_markedCollectedPositions.empty() ||
+				(_markedCollectedPositions.size() == 1 && *_markedCollectedPositions.begin() == _activeHuntedShaderIndex))
 			{
 				return;
 			}
@@ -316,32 +386,22 @@ namespace ShaderToggler
 				startIndex = 0;
 			}
 
-			int index = startIndex;
-			for (int step = 0; step < collectedCount; ++step)
-			{
-				index = (index - 1 + collectedCount) % collectedCount;
-				const uint32_t hash = _huntShaderHashesSnapshot[static_cast<size_t>(index)];
-				if (_markedShaderHashes.count(hash) == 1)
-				{
-					_activeHuntedShaderIndex = index;
-					_activeHuntedShaderHash = hash;
-					return;
-				}
-			}
+			auto previous = _markedCollectedPositions.lower_bound(startIndex);
+			previous = previous == _markedCollectedPositions.begin() ? std::prev(_markedCollectedPositions.end()) : std::prev(previous);
 
+			_activeHuntedShaderIndex = *previous;
+			_activeHuntedShaderHash = _collectedActiveShaderHashesOrdered[static_cast<size_t>(*previous)];
 			return;
 		}
 
-		if (_activeHuntedShaderIndex <= 0)
+		int index = _activeHuntedShaderIndex;
+		do
 		{
-			_activeHuntedShaderIndex = collectedCount - 1;
-		}
-		else
-		{
-			--_activeHuntedShaderIndex;
-		}
+			index = (index > 0 && index < collectedCount) ? index - 1 : collectedCount - 1;
+		} while (_collectedActiveShaderHashesOrdered[static_cast<size_t>(index)] == 0);
 
-		syncActiveHuntedShaderToSnapshotLocked();
+		_activeHuntedShaderIndex = index;
+		syncActiveHuntedShaderToCollectedLocked();
 	}
 
 	bool ShaderManager::isBlockedShader(uint32_t shaderHash)
@@ -364,16 +424,22 @@ namespace ShaderToggler
 
 	void ShaderManager::addActivePipelineHandle(uint64_t handle)
 	{
-		const auto shaderHash = getShaderHash(handle);
-		if (shaderHash > 0)
+		uint32_t shaderHash = 0;
 		{
-			std::unique_lock lock(_collectedActiveHandlesMutex);
+			std::shared_lock lock(_hashHandlesMutex);
 
-			if (_collectedActiveShaderHashes.emplace(shaderHash).second)
+			const auto it = _handleToShaderHash.find(handle);
+			if (it == _handleToShaderHash.end() ||
+				(it->second.state.getMatchingHuntFilters() & _huntCandidateFilterBit.load(std::memory_order_relaxed)) == 0)
 			{
-				_collectedActiveShaderHashesOrdered.push_back(shaderHash);
+				return;
 			}
+
+			shaderHash = it->second.shaderHash;
 		}
+
+		std::unique_lock lock(_collectedActiveHandlesMutex);
+		appendCollectedShaderHashLocked(shaderHash);
 	}
 
 	void ShaderManager::toggleMarkOnHuntedShader()
@@ -383,14 +449,28 @@ namespace ShaderToggler
 			return;
 		}
 
+		std::unique_lock collectedLock(_collectedActiveHandlesMutex);
 		std::unique_lock lock(_markedShaderHashMutex);
+
+		const bool activeIndexInCollected = _activeHuntedShaderIndex >= 0 &&
+			_activeHuntedShaderIndex < static_cast<int>(_collectedActiveShaderHashesOrdered.size()) &&
+			_collectedActiveShaderHashesOrdered[static_cast<size_t>(_activeHuntedShaderIndex)] == _activeHuntedShaderHash;
+
 		if (_markedShaderHashes.count(_activeHuntedShaderHash) == 1)
 		{
 			_markedShaderHashes.erase(_activeHuntedShaderHash);
+			if (activeIndexInCollected)
+			{
+				_markedCollectedPositions.erase(_activeHuntedShaderIndex);
+			}
 		}
 		else
 		{
 			_markedShaderHashes.emplace(_activeHuntedShaderHash);
+			if (activeIndexInCollected)
+			{
+				_markedCollectedPositions.emplace(_activeHuntedShaderIndex);
+			}
 		}
 	}
 
@@ -404,6 +484,108 @@ namespace ShaderToggler
 			return 0;
 		}
 
-		return it->second;
+		return it->second.shaderHash;
+	}
+
+	void ShaderManager::recordActivePipelineHandle(uint64_t handle, uint32_t frameEpoch)
+	{
+		std::shared_lock lock(_hashHandlesMutex);
+
+		const auto it = _handleToShaderHash.find(handle);
+		if (it == _handleToShaderHash.end())
+		{
+			return;
+		}
+
+		// Epoch 0 means 'never seen', so stamps are stored off by one. Skipping the store when the
+		// slot already carries this frame keeps the cache line shared between render threads.
+		std::atomic_uint32_t& lastSeen = _lastSeenFrameByDenseIndex[it->second.denseIndex];
+		const uint32_t stamp = frameEpoch + 1;
+		if (lastSeen.load(std::memory_order_relaxed) != stamp)
+		{
+			lastSeen.store(stamp, std::memory_order_relaxed);
+		}
+	}
+
+	uint32_t ShaderManager::seedCollectedFromRecentFrames(uint32_t currentFrameEpoch, uint32_t frameWindow)
+	{
+		std::shared_lock hashLock(_hashHandlesMutex);
+		std::unique_lock collectedLock(_collectedActiveHandlesMutex);
+
+		const uint32_t currentStamp = currentFrameEpoch + 1;
+		const uint8_t filterBit = _huntCandidateFilterBit.load(std::memory_order_relaxed);
+		uint32_t amountSeeded = 0;
+
+		for (size_t denseIndex = 0; denseIndex < _denseIndexToShaderHash.size(); ++denseIndex)
+		{
+			if ((_huntFilterMatchesByDenseIndex[denseIndex] & filterBit) == 0)
+			{
+				continue;
+			}
+
+			const uint32_t lastSeenStamp = _lastSeenFrameByDenseIndex[denseIndex].load(std::memory_order_relaxed);
+			if (lastSeenStamp == 0 || currentStamp - lastSeenStamp > frameWindow)
+			{
+				continue;
+			}
+
+			const uint32_t shaderHash = _denseIndexToShaderHash[denseIndex];
+			if (_pipelineCountByShaderHash.count(shaderHash) == 0)
+			{
+				continue;
+			}
+
+			if (appendCollectedShaderHashLocked(shaderHash))
+			{
+				++amountSeeded;
+			}
+		}
+
+		return amountSeeded;
+	}
+
+	void ShaderManager::fillActiveBitsForFrame(uint32_t frameEpoch, std::vector<uint64_t>& activeBits)
+	{
+		std::shared_lock lock(_hashHandlesMutex);
+
+		const size_t denseCount = _denseIndexToShaderHash.size();
+		activeBits.assign((denseCount + 63) / 64, 0);
+
+		const uint32_t stamp = frameEpoch + 1;
+		for (size_t denseIndex = 0; denseIndex < denseCount; ++denseIndex)
+		{
+			if (_lastSeenFrameByDenseIndex[denseIndex].load(std::memory_order_relaxed) == stamp)
+			{
+				activeBits[denseIndex / 64] |= 1ull << (denseIndex % 64);
+			}
+		}
+	}
+
+	uint32_t ShaderManager::replaceCollectedFromDenseIndices(const std::vector<uint32_t>& denseIndices)
+	{
+		std::shared_lock hashLock(_hashHandlesMutex);
+		std::unique_lock collectedLock(_collectedActiveHandlesMutex);
+
+		clearCollectedLocked();
+
+		const uint8_t filterBit = _huntCandidateFilterBit.load(std::memory_order_relaxed);
+		for (const uint32_t denseIndex : denseIndices)
+		{
+			if (denseIndex >= _denseIndexToShaderHash.size() || (_huntFilterMatchesByDenseIndex[denseIndex] & filterBit) == 0)
+			{
+				continue;
+			}
+
+			const uint32_t shaderHash = _denseIndexToShaderHash[denseIndex];
+			if (_pipelineCountByShaderHash.count(shaderHash) == 1)
+			{
+				appendCollectedShaderHashLocked(shaderHash);
+			}
+		}
+
+		_activeHuntedShaderIndex = -1;
+		_activeHuntedShaderHash = 0;
+
+		return static_cast<uint32_t>(_collectedActiveShaderHashesOrdered.size());
 	}
 }
\ No newline at end of file
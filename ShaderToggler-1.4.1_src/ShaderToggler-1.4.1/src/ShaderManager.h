@@ -39,12 +39,18 @@
 
 #include <map>
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <reshade_api_device.hpp>
 #include <reshade_api_pipeline.hpp>
 #include <shared_mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "CDataFile.h"
+#include "PipelineStateInfo.h"
 #include "ToggleGroup.h"
 
 namespace ShaderToggler
@@ -54,7 +60,7 @@ namespace ShaderToggler
 	public:
 		ShaderManager();
 
-		void addHashHandlePair(uint32_t shaderHash, uint64_t pipelineHandle);
+		void addHashHandlePair(uint32_t shaderHash, uint64_t pipelineHandle, const PipelineStateInfo& pipelineState);
 		void removeHandle(uint64_t handle);
 
 		void startHuntingMode(const std::unordered_set<uint32_t> currentMarkedHashes);
@@ -71,6 +77,16 @@ namespace ShaderToggler
 		void addActivePipelineHandle(uint64_t handle);
 		void toggleMarkOnHuntedShader();
 
+		// Background sampling: stamps the frame epoch a pipeline's shader was last bound in, so a
+		// hunting session can start from the shaders seen in the last N frames without a collection phase.
+		void recordActivePipelineHandle(uint64_t handle, uint32_t frameEpoch);
+		uint32_t seedCollectedFromRecentFrames(uint32_t currentFrameEpoch, uint32_t frameWindow);
+
+		// Activity history: per-frame bitset over the dense indices stamped with the given frame, and
+		// replacing the hunting candidates with the shaders behind a set of dense indices.
+		void fillActiveBitsForFrame(uint32_t frameEpoch, std::vector<uint64_t>& activeBits);
+		uint32_t replaceCollectedFromDenseIndices(const std::vector<uint32_t>& denseIndices);
+
 		uint32_t getPipelineCount()
 		{
 			std::shared_lock lock(_hashHandlesMutex);
@@ -80,15 +96,18 @@ namespace ShaderToggler
 		uint32_t getShaderCount()
 		{
 			std::shared_lock lock(_hashHandlesMutex);
-			return static_cast<uint32_t>(_shaderHashes.size());
+			return static_cast<uint32_t>(_pipelineCountByShaderHash.size());
 		}
 
 		uint32_t getAmountShaderHashesCollected()
 		{
 			std::shared_lock lock(_collectedActiveHandlesMutex);
-			return static_cast<uint32_t>(_collectedActiveShaderHashesOrdered.size());
+			return static_cast<uint32_t>(_collectedActiveShaderHashesOrdered.size() - _collectedTombstoneCount);
 		}
 
+		// Collection, seeding and history only pick up shaders whose pipeline state passes this filter.
+		void setHuntCandidateFilter(HuntCandidateFilter filter) { _huntCandidateFilterBit = static_cast<uint8_t>(1 << static_cast<uint8_t>(filter)); }
+
 		bool isInHuntingMode() { return _isInHuntingMode; }
 		uint32_t getActiveHuntedShaderHash() { return _activeHuntedShaderHash; }
 		int getActiveHuntedShaderIndex() { return _activeHuntedShaderIndex; }
@@ -119,16 +138,39 @@ namespace ShaderToggler
 		}
 		
 	private:
-		void setActiveHuntedShaderHandle();
-		void rebuildHuntSnapshotLocked();
-		void syncActiveHuntedShaderToSnapshotLocked();
-
-		std::unordered_set<uint32_t> _shaderHashes;					
-		std::map<uint64_t, uint32_t> _handleToShaderHash;			
+		struct PipelineEntry
+		{
+			uint32_t shaderHash;
+			uint32_t denseIndex;
+			PipelineStateInfo state;
+		};
 
-		std::unordered_set<uint32_t> _collectedActiveShaderHashes;	
+		void setActiveHuntedShaderHandle();
+		bool appendCollectedShaderHashLocked(uint32_t shaderHash);
+		void removeCollectedShaderHashLocked(uint32_t shaderHash);
+		void compactCollectedLocked();
+		void clearCollectedLocked();
+		void syncActiveHuntedShaderToCollectedLocked();
+		void rebuildMarkedCollectedPositionsLocked();
+		uint32_t getOrAssignDenseIndexLocked(uint32_t shaderHash);
+
+		std::unordered_map<uint32_t, uint32_t> _pipelineCountByShaderHash;	// shader hash -> # of pipelines using it
+		std::map<uint64_t, PipelineEntry> _handleToShaderHash;			
+
+		// Dense, never recycled index per shader hash. The last-seen array is only grown under the
+		// unique hash lock; binds write into it with relaxed stores while holding the shared lock.
+		std::unordered_map<uint32_t, uint32_t> _shaderHashToDenseIndex;
+		std::vector<uint32_t> _denseIndexToShaderHash;
+		std::vector<uint8_t> _huntFilterMatchesByDenseIndex;		// OR of getMatchingHuntFilters() over the pipelines using the shader
+		std::unique_ptr<std::atomic_uint32_t[]> _lastSeenFrameByDenseIndex;
+		size_t _lastSeenFrameCapacity = 0;
+
+		// Collected shaders in collection order; hunting navigates this list directly. Shaders whose last
+		// pipeline is destroyed leave a 0 tombstone so positions stay stable, until compaction.
 		std::vector<uint32_t> _collectedActiveShaderHashesOrdered;	
-		std::vector<uint32_t> _huntShaderHashesSnapshot;			
+		std::unordered_map<uint32_t, int> _collectedPositionByShaderHash;
+		size_t _collectedTombstoneCount = 0;
+		std::set<int> _markedCollectedPositions;					// positions in the collected list whose hash is marked, for Ctrl+navigation
 
 		std::unordered_set<uint32_t> _markedShaderHashes;			
 
@@ -139,5 +181,6 @@ namespace ShaderToggler
 		std::shared_mutex _hashHandlesMutex;
 		std::shared_mutex _markedShaderHashMutex;
 		bool _hideMarkedShaders = false;
+		std::atomic_uint8_t _huntCandidateFilterBit = 1;
 	};
 }
\ No newline at end of file
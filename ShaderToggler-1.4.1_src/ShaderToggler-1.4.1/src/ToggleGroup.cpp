@@ -1,7 +1,11 @@
 #include "ToggleGroup.h"
 #include "CDataFile.h"
+#include "ConfigCache.h"
+#include "HashPackMerge.h"
+#include <atomic>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 //GT
 namespace ShaderToggler
 {
@@ -20,9 +24,21 @@ namespace ShaderToggler
 	}
 
 	static ToggleGroup::GroupId s_nextGroupId = 1;
+	// atomic: the config persistence worker loads scratch groups to build the config cache.
+	static std::atomic<uint32_t> s_revisionCounter = 0;
+
+	// The packed hex lists are shared with hash pack imports, so both read and write them the same way.
+	// Sorted so the saved file only changes where the set changed.
+	static std::string packHashes(const std::unordered_set<uint32_t>& hashes)
+	{
+		std::vector<uint32_t> sorted(hashes.begin(), hashes.end());
+		std::sort(sorted.begin(), sorted.end());
+		return HashPackMerge::formatHashList(sorted);
+	}
 
 	ToggleGroup::ToggleGroup(const std::string& name, GroupId id)
 		: m_id(id)
+		, m_revision(++s_revisionCounter)
 		, m_name(name)
 		, m_notice("")
 		, m_active(false)
@@ -47,23 +63,60 @@ namespace ShaderToggler
 		return s_nextGroupId++;
 	}
 
+	uint32_t ToggleGroup::getLatestRevision()
+	{
+		return s_revisionCounter;
+	}
+
 	ToggleGroup::GroupId ToggleGroup::getId() const { return m_id; }
 	void ToggleGroup::setId(GroupId id) { m_id = id; }
 
+	uint32_t ToggleGroup::getRevision() const { return m_revision; }
+	void ToggleGroup::bumpRevision() { m_revision = ++s_revisionCounter; }
+
 	const std::string& ToggleGroup::getName() const { return m_name; }
-	void ToggleGroup::setName(const std::string& name) { m_name = name; }
+	void ToggleGroup::setName(const std::string& name)
+	{
+		// the editor sets the name every frame it is open.
+		if (m_name == name)
+			return;
+
+		bumpRevision();
+		m_name = name;
+	}
 
 	const std::string& ToggleGroup::getNotice() const { return m_notice; }
-	void ToggleGroup::setNotice(const std::string& notice) { m_notice = notice; }
+	void ToggleGroup::setNotice(const std::string& notice)
+	{
+		if (m_notice == notice)
+			return;
+
+		bumpRevision();
+		m_notice = notice;
+	}
 
 	bool ToggleGroup::isActive() const { return m_active; }
 	void ToggleGroup::setActive(bool active) { m_active = active; }
 
 	bool ToggleGroup::isActiveAtStartup() const { return m_activeAtStartup; }
-	void ToggleGroup::setIsActiveAtStartup(bool startup) { m_activeAtStartup = startup; }
+	void ToggleGroup::setIsActiveAtStartup(bool startup)
+	{
+		if (m_activeAtStartup == startup)
+			return;
+
+		bumpRevision();
+		m_activeAtStartup = startup;
+	}
 
 	bool ToggleGroup::isStartupTimed() const { return m_startupTimed; }
-	void ToggleGroup::setStartupTimed(bool timed) { m_startupTimed = timed; }
+	void ToggleGroup::setStartupTimed(bool timed)
+	{
+		if (m_startupTimed == timed)
+			return;
+
+		bumpRevision();
+		m_startupTimed = timed;
+	}
 
 	int ToggleGroup::getStartupDurationMs() const { return m_startupDurationMs; }
 	void ToggleGroup::setStartupDurationMs(int durationMs)
@@ -72,6 +125,10 @@ namespace ShaderToggler
 			durationMs = 100;
 		if (durationMs > 3600000)
 			durationMs = 3600000;
+		if (m_startupDurationMs == durationMs)
+			return;
+
+		bumpRevision();
 		m_startupDurationMs = durationMs;
 	}
 
@@ -81,39 +138,52 @@ namespace ShaderToggler
 	bool ToggleGroup::isHoldMode() const { return m_holdMode; }
 	void ToggleGroup::setHoldMode(bool holdMode)
 	{
-		m_holdMode = holdMode;
-		if (!m_holdMode)
-			m_holdInverted = false;
+		const bool holdInverted = holdMode && m_holdInverted;
+		const bool timedMode = !holdMode && m_timedMode;
+		if (m_holdMode == holdMode && m_holdInverted == holdInverted && m_timedMode == timedMode)
+			return;
 
-		if (m_holdMode)
-			m_timedMode = false;
+		bumpRevision();
+		m_holdMode = holdMode;
+		m_holdInverted = holdInverted;
+		m_timedMode = timedMode;
 	}
 
 	bool ToggleGroup::isHoldInverted() const { return m_holdInverted; }
 	void ToggleGroup::setHoldInverted(bool holdInverted)
 	{
+		const bool holdMode = holdInverted || m_holdMode;
+		const bool timedMode = !holdInverted && m_timedMode;
+		if (m_holdInverted == holdInverted && m_holdMode == holdMode && m_timedMode == timedMode)
+			return;
+
+		bumpRevision();
 		m_holdInverted = holdInverted;
-		if (m_holdInverted)
-		{
-			m_holdMode = true;
-			m_timedMode = false;
-		}
+		m_holdMode = holdMode;
+		m_timedMode = timedMode;
 	}
 
 	bool ToggleGroup::isTimedMode() const { return m_timedMode; }
 	void ToggleGroup::setTimedMode(bool timedMode)
 	{
+		const bool holdMode = !timedMode && m_holdMode;
+		const bool holdInverted = !timedMode && m_holdInverted;
+		if (m_timedMode == timedMode && m_holdMode == holdMode && m_holdInverted == holdInverted)
+			return;
+
+		bumpRevision();
 		m_timedMode = timedMode;
-		if (m_timedMode)
-		{
-			m_holdMode = false;
-			m_holdInverted = false;
-		}
+		m_holdMode = holdMode;
+		m_holdInverted = holdInverted;
 	}
 
 	bool ToggleGroup::isTimedModeInverted() const { return m_timedModeInverted; }
 	void ToggleGroup::setTimedModeInverted(bool inverted)
 	{
+		if (m_timedModeInverted == inverted)
+			return;
+
+		bumpRevision();
 		m_timedModeInverted = inverted;
 	}
 
@@ -122,7 +192,10 @@ namespace ShaderToggler
 	{
 		if (delayMs < 100)
 			delayMs = 100;
+		if (m_timedModeDelayMs == delayMs)
+			return;
 
+		bumpRevision();
 		m_timedModeDelayMs = delayMs;
 	}
 
@@ -131,7 +204,10 @@ namespace ShaderToggler
 	{
 		if (visibleMs < 0)
 			visibleMs = 0;
+		if (m_timedModeMinVisibleMs == visibleMs)
+			return;
 
+		bumpRevision();
 		m_timedModeMinVisibleMs = visibleMs;
 	}
 
@@ -140,7 +216,10 @@ namespace ShaderToggler
 	{
 		if (fadeOutMs < 0)
 			fadeOutMs = 0;
+		if (m_timedModeFadeOutMs == fadeOutMs)
+			return;
 
+		bumpRevision();
 		m_timedModeFadeOutMs = fadeOutMs;
 	}
 
@@ -151,17 +230,26 @@ namespace ShaderToggler
 			lingerMs = 0;
 		if (lingerMs > 2000)
 			lingerMs = 2000;
+		if (m_timedSuppressionLingerMs == lingerMs)
+			return;
 
+		bumpRevision();
 		m_timedSuppressionLingerMs = lingerMs;
 	}
 //GT
 	void ToggleGroup::setToggleKey(uint8_t newKeyValue, bool shiftRequired, bool altRequired, bool ctrlRequired)
 	{
-		m_toggleKey.setKey(newKeyValue, shiftRequired, altRequired, ctrlRequired);
+		KeyData key;
+		key.setKey(newKeyValue, shiftRequired, altRequired, ctrlRequired);
+		setToggleKey(key);
 	}
 
 	void ToggleGroup::setToggleKey(const KeyData& key)
 	{
+		if (m_toggleKey.toInt() == key.toInt())
+			return;
+
+		bumpRevision();
 		m_toggleKey = key;
 	}
 
@@ -180,6 +268,7 @@ namespace ShaderToggler
 		if (!key.isValid())
 			return;
 
+		bumpRevision();
 		TimedTriggerBinding binding;
 		binding.key = key;
 		binding.mode = mode;
@@ -193,6 +282,10 @@ namespace ShaderToggler
 
 		if (index < m_timedTriggerKeys.size())
 		{
+			if (m_timedTriggerKeys[index].key.toInt() == key.toInt())
+				return;
+
+			bumpRevision();
 			m_timedTriggerKeys[index].key = key;
 		}
 		else if (index == m_timedTriggerKeys.size())
@@ -203,8 +296,11 @@ namespace ShaderToggler
 
 	void ToggleGroup::setTimedTriggerModeAt(size_t index, TimedTriggerMode mode)
 	{
-		if (index < m_timedTriggerKeys.size())
-			m_timedTriggerKeys[index].mode = mode;
+		if (index >= m_timedTriggerKeys.size() || m_timedTriggerKeys[index].mode == mode)
+			return;
+
+		bumpRevision();
+		m_timedTriggerKeys[index].mode = mode;
 	}
 
 	void ToggleGroup::setTimedTriggerBindingAt(size_t index, const TimedTriggerBinding& binding)
@@ -214,10 +310,16 @@ namespace ShaderToggler
 
 		if (index < m_timedTriggerKeys.size())
 		{
+			const TimedTriggerBinding& current = m_timedTriggerKeys[index];
+			if (current.key.toInt() == binding.key.toInt() && current.mode == binding.mode)
+				return;
+
+			bumpRevision();
 			m_timedTriggerKeys[index] = binding;
 		}
 		else if (index == m_timedTriggerKeys.size())
 		{
+			bumpRevision();
 			m_timedTriggerKeys.push_back(binding);
 		}
 	}
@@ -227,11 +329,16 @@ namespace ShaderToggler
 		if (index >= m_timedTriggerKeys.size())
 			return;
 
+		bumpRevision();
 		m_timedTriggerKeys.erase(m_timedTriggerKeys.begin() + static_cast<std::ptrdiff_t>(index));
 	}
 
 	void ToggleGroup::clearTimedTriggerKeys()
 	{
+		if (m_timedTriggerKeys.empty())
+			return;
+
+		bumpRevision();
 		m_timedTriggerKeys.clear();
 	}
 
@@ -275,6 +382,7 @@ namespace ShaderToggler
 		if (!key.isValid())
 			return;
 
+		bumpRevision();
 		m_timedSuppressionKeys.push_back(key);
 	}
 
@@ -285,6 +393,10 @@ namespace ShaderToggler
 
 		if (index < m_timedSuppressionKeys.size())
 		{
+			if (m_timedSuppressionKeys[index].toInt() == key.toInt())
+				return;
+
+			bumpRevision();
 			m_timedSuppressionKeys[index] = key;
 		}
 		else if (index == m_timedSuppressionKeys.size())
@@ -298,11 +410,16 @@ namespace ShaderToggler
 		if (index >= m_timedSuppressionKeys.size())
 			return;
 
+		bumpRevision();
 		m_timedSuppressionKeys.erase(m_timedSuppressionKeys.begin() + static_cast<std::ptrdiff_t>(index));
 	}
 
 	void ToggleGroup::clearTimedSuppressionKeys()
 	{
+		if (m_timedSuppressionKeys.empty())
+			return;
+
+		bumpRevision();
 		m_timedSuppressionKeys.clear();
 	}
 
@@ -367,6 +484,7 @@ namespace ShaderToggler
 
 	void ToggleGroup::clearHashes()
 	{
+		bumpRevision();
 		m_pixelShaderHashes.clear();
 		m_vertexShaderHashes.clear();
 		m_computeShaderHashes.clear();
@@ -377,6 +495,7 @@ namespace ShaderToggler
 		const std::unordered_set<uint32_t>& vertex,
 		const std::unordered_set<uint32_t>& compute)
 	{
+		bumpRevision();
 		m_pixelShaderHashes = pixel;
 		m_vertexShaderHashes = vertex;
 		m_computeShaderHashes = compute;
@@ -391,13 +510,15 @@ namespace ShaderToggler
 		ToggleGroup copy(*this);
 		copy.m_id = getNewGroupId();
 		copy.m_name += " Copy";
+		copy.bumpRevision();
 		copy.m_active = false;
 		copy.m_editing = false;
 		return copy;
 	}
 //GT
-	void ToggleGroup::loadState(CDataFile& iniFile, int index, bool usingCustomFormat)
+	void ToggleGroup::loadState(CDataFile& iniFile, int index, bool usingCustomFormat, int hashFormat)
 	{
+		bumpRevision();
 		clearHashes();
 		m_notice.clear();
 		m_startupTimed = false;
@@ -464,28 +585,37 @@ namespace ShaderToggler
 		const std::string pixelHashesCategory = sectionRoot + "_PixelShaders";
 		const std::string computeHashesCategory = sectionRoot + "_ComputeShaders";
 
-		int amountShaders = iniFile.GetInt("AmountHashes", vertexHashesCategory);
-		for (int i = 0; i < amountShaders; i++)
+		if (hashFormat >= PackedHashFormat)
 		{
-			uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), vertexHashesCategory);
-			if (hash != UINT_MAX)
-				m_vertexShaderHashes.insert(hash);
+			HashPackMerge::parseHashList(iniFile.GetValue("VertexShaderHashes", sectionRoot), m_vertexShaderHashes);
+			HashPackMerge::parseHashList(iniFile.GetValue("PixelShaderHashes", sectionRoot), m_pixelShaderHashes);
+			HashPackMerge::parseHashList(iniFile.GetValue("ComputeShaderHashes", sectionRoot), m_computeShaderHashes);
 		}
-
-		amountShaders = iniFile.GetInt("AmountHashes", pixelHashesCategory);
-		for (int i = 0; i < amountShaders; i++)
+		else
 		{
-			uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), pixelHashesCategory);
-			if (hash != UINT_MAX)
-				m_pixelShaderHashes.insert(hash);
-		}
+			int amountShaders = iniFile.GetInt("AmountHashes", vertexHashesCategory);
+			for (int i = 0; i < amountShaders; i++)
+			{
+				uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), vertexHashesCategory);
+				if (hash != UINT_MAX)
+					m_vertexShaderHashes.insert(hash);
+			}
+
+			amountShaders = iniFile.GetInt("AmountHashes", pixelHashesCategory);
+			for (int i = 0; i < amountShaders; i++)
+			{
+				uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), pixelHashesCategory);
+				if (hash != UINT_MAX)
+					m_pixelShaderHashes.insert(hash);
+			}
 //GT
-		amountShaders = iniFile.GetInt("AmountHashes", computeHashesCategory);
-		for (int i = 0; i < amountShaders; i++)
-		{
-			uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), computeHashesCategory);
-			if (hash != UINT_MAX)
-				m_computeShaderHashes.insert(hash);
+			amountShaders = iniFile.GetInt("AmountHashes", computeHashesCategory);
+			for (int i = 0; i < amountShaders; i++)
+			{
+				uint32_t hash = iniFile.GetUInt("ShaderHash" + std::to_string(i), computeHashesCategory);
+				if (hash != UINT_MAX)
+					m_computeShaderHashes.insert(hash);
+			}
 		}
 
 		m_name = iniFile.GetValue("Name", sectionRoot);
@@ -618,33 +748,11 @@ namespace ShaderToggler
 	{
 		const std::string prefix = usingCustomFormat ? "GTGroup" : "Group";
 		const std::string sectionRoot = prefix + std::to_string(index);
-		const std::string vertexHashesCategory = sectionRoot + "_VertexShaders";
-		const std::string pixelHashesCategory = sectionRoot + "_PixelShaders";
-		const std::string computeHashesCategory = sectionRoot + "_ComputeShaders";
-
-		int counter = 0;
-		for (const auto hash : m_vertexShaderHashes)
-		{
-			iniFile.SetUInt("ShaderHash" + std::to_string(counter), hash, "", vertexHashesCategory);
-			counter++;
-		}
-		iniFile.SetUInt("AmountHashes", counter, "", vertexHashesCategory);
 
-		counter = 0;
-		for (const auto hash : m_pixelShaderHashes)
-		{
-			iniFile.SetUInt("ShaderHash" + std::to_string(counter), hash, "", pixelHashesCategory);
-			counter++;
-		}
-		iniFile.SetUInt("AmountHashes", counter, "", pixelHashesCategory);
-
-		counter = 0;
-		for (const auto hash : m_computeShaderHashes)
-		{
-			iniFile.SetUInt("ShaderHash" + std::to_string(counter), hash, "", computeHashesCategory);
-			counter++;
-		}
-		iniFile.SetUInt("AmountHashes", counter, "", computeHashesCategory);
+		// empty lists are left out; a missing key loads as no hashes.
+		iniFile.SetValue("VertexShaderHashes", packHashes(m_vertexShaderHashes), "", sectionRoot);
+		iniFile.SetValue("PixelShaderHashes", packHashes(m_pixelShaderHashes), "", sectionRoot);
+		iniFile.SetValue("ComputeShaderHashes", packHashes(m_computeShaderHashes), "", sectionRoot);
 
 		iniFile.SetValue("Name", m_name, "", sectionRoot);
 		iniFile.SetValue("Notice", m_notice, "", sectionRoot);
@@ -697,5 +805,115 @@ namespace ShaderToggler
 		iniFile.SetInt("TimedModeFadeOutMs", m_timedModeFadeOutMs, "", sectionRoot);
 		iniFile.SetInt("TimedSuppressionLingerMs", m_timedSuppressionLingerMs, "", sectionRoot);
 	}
+
+	static void writeSortedHashes(ConfigCacheWriter& writer, const std::unordered_set<uint32_t>& hashes)
+	{
+		std::vector<uint32_t> sorted(hashes.begin(), hashes.end());
+		std::sort(sorted.begin(), sorted.end());
+		writer.writeUIntArray(sorted);
+	}
+
+	static void readHashes(ConfigCacheReader& reader, std::unordered_set<uint32_t>& hashes)
+	{
+		const uint32_t* values = nullptr;
+		const uint32_t count = reader.readUIntArray(values);
+		hashes.reserve(count);
+		hashes.insert(values, values + count);
+	}
+
+	void ToggleGroup::saveCacheState(ConfigCacheWriter& writer) const
+	{
+		writer.writeString(m_name);
+		writer.writeString(m_notice);
+		writer.writeUInt(static_cast<uint32_t>(m_toggleKey.toInt()));
+
+		const uint32_t flags =
+			(m_activeAtStartup ? 1u : 0u) |
+			(m_startupTimed ? 2u : 0u) |
+			(m_holdMode ? 4u : 0u) |
+			(m_holdInverted ? 8u : 0u) |
+			(m_timedMode ? 16u : 0u) |
+			(m_timedModeInverted ? 32u : 0u);
+		writer.writeUInt(flags);
+		writer.writeInt(m_startupDurationMs);
+		writer.writeInt(m_timedModeDelayMs);
+		writer.writeInt(m_timedModeMinVisibleMs);
+		writer.writeInt(m_timedModeFadeOutMs);
+		writer.writeInt(m_timedSuppressionLingerMs);
+
+		uint32_t validTimedTriggerKeys = 0;
+		for (const TimedTriggerBinding& binding : m_timedTriggerKeys)
+			validTimedTriggerKeys += binding.key.isValid() ? 1 : 0;
+		writer.writeUInt(validTimedTriggerKeys);
+		for (const TimedTriggerBinding& binding : m_timedTriggerKeys)
+		{
+			if (!binding.key.isValid())
+				continue;
+
+			writer.writeUInt(static_cast<uint32_t>(binding.key.toInt()));
+			writer.writeInt(timedTriggerModeToInt(binding.mode));
+		}
+
+		uint32_t validTimedSuppressionKeys = 0;
+		for (const KeyData& key : m_timedSuppressionKeys)
+			validTimedSuppressionKeys += key.isValid() ? 1 : 0;
+		writer.writeUInt(validTimedSuppressionKeys);
+		for (const KeyData& key : m_timedSuppressionKeys)
+		{
+			if (key.isValid())
+				writer.writeUInt(static_cast<uint32_t>(key.toInt()));
+		}
+
+		writeSortedHashes(writer, m_pixelShaderHashes);
+		writeSortedHashes(writer, m_vertexShaderHashes);
+		writeSortedHashes(writer, m_computeShaderHashes);
+	}
+
+	bool ToggleGroup::loadCacheState(ConfigCacheReader& reader)
+	{
+		bumpRevision();
+		clearHashes();
+		m_timedTriggerKeys.clear();
+		m_timedSuppressionKeys.clear();
+
+		m_name = reader.readString();
+		m_notice = reader.readString();
+		m_toggleKey = KeyData::fromInt(reader.readUInt());
+
+		const uint32_t flags = reader.readUInt();
+		m_activeAtStartup = (flags & 1u) != 0;
+		m_startupTimed = (flags & 2u) != 0;
+		m_holdMode = (flags & 4u) != 0;
+		m_holdInverted = (flags & 8u) != 0;
+		m_timedMode = (flags & 16u) != 0;
+		m_timedModeInverted = (flags & 32u) != 0;
+		m_startupDurationMs = reader.readInt();
+		m_timedModeDelayMs = reader.readInt();
+		m_timedModeMinVisibleMs = reader.readInt();
+		m_timedModeFadeOutMs = reader.readInt();
+		m_timedSuppressionLingerMs = reader.readInt();
+		m_active = m_activeAtStartup;
+
+		const uint32_t timedTriggerKeyCount = reader.readUInt();
+		for (uint32_t i = 0; i < timedTriggerKeyCount && !reader.failed(); ++i)
+		{
+			TimedTriggerBinding binding;
+			binding.key = KeyData::fromInt(reader.readUInt());
+			binding.mode = timedTriggerModeFromInt(reader.readInt());
+			m_timedTriggerKeys.push_back(binding);
+		}
+
+		const uint32_t timedSuppressionKeyCount = reader.readUInt();
+		for (uint32_t i = 0; i < timedSuppressionKeyCount && !reader.failed(); ++i)
+		{
+			m_timedSuppressionKeys.push_back(KeyData::fromInt(reader.readUInt()));
+		}
+
+		readHashes(reader, m_pixelShaderHashes);
+		readHashes(reader, m_vertexShaderHashes);
+		readHashes(reader, m_computeShaderHashes);
+
+		return !reader.failed();
+	}
 }
 //GT
\ No newline at end of file
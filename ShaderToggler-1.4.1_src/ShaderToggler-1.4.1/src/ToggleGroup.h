@@ -37,9 +37,14 @@ namespace ShaderToggler
 		ToggleGroup(const ToggleGroup& other) = default;
 
 		static GroupId getNewGroupId();
+		// The newest revision handed out to any group: changes whenever a persisted setting of any group,
+		// its key bindings included, changes, or a group is created.
+		static uint32_t getLatestRevision();
 
 		GroupId getId() const;
 		void setId(GroupId id);
+		// Changes whenever a persisted setting of this group changes; used to cache its config signature.
+		uint32_t getRevision() const;
 
 		const std::string& getName() const;
 		void setName(const std::string& name);
@@ -129,8 +134,16 @@ namespace ShaderToggler
 		const std::unordered_set<uint32_t>& getVertexShaderHashes() const;
 		const std::unordered_set<uint32_t>& getComputeShaderHashes() const;
 
-		void loadState(class CDataFile& iniFile, int index, bool usingCustomFormat);
+		// Hash storage of a saved group: one ShaderHashN key per hash in separate stage sections (1), or
+		// one sorted, comma separated hex list per stage in the group section (2, written by saveState).
+		static constexpr int LegacyHashFormat = 1;
+		static constexpr int PackedHashFormat = 2;
+
+		void loadState(class CDataFile& iniFile, int index, bool usingCustomFormat, int hashFormat = LegacyHashFormat);
 		void saveState(class CDataFile& iniFile, int index, bool usingCustomFormat) const;
+		// Same settings in the binary config cache, with each stage's hashes as a sorted array.
+		bool loadCacheState(class ConfigCacheReader& reader);
+		void saveCacheState(class ConfigCacheWriter& writer) const;
 
 		ToggleGroup makeDuplicate() const;
 
@@ -141,7 +154,10 @@ namespace ShaderToggler
 		static constexpr int getProvenanceRevision() { return STA_TOGGLEGROUP_PROVENANCE_REV; }
 
 	private:
+		void bumpRevision();
+
 		GroupId m_id;
+		uint32_t m_revision;
 		std::string m_name;
 		std::string m_notice;
 		bool m_active;
@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// Time to load a config of about 10 MB from disk into a CDataFile: the block parser CDataFile::Load uses now
+// against the getline loop it replaced. The packed layout has few, very long lines; the per-key layout of older
+// configs has hundreds of thousands of short ones.
+
+#include "CDataFile.h"
+#include "LargeConfig.h"
+#include "LegacyDataFileLoader.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace ShaderTogglerTests;
+
+namespace
+{
+	constexpr int Iterations = 5;
+
+	// Returns the keys loaded by the last iteration, so both loaders can be checked against each other.
+	template <typename Loader>
+	double benchmarkLoad(const std::filesystem::path& fileName, int& keyCount, Loader&& load)
+	{
+		return measureNsPerIteration(Iterations, [&](int)
+			{
+				CDataFile data;
+				load(data, fileName);
+				keyCount = data.KeyCount();
+				// only an in-memory model; clearing it keeps its destructor from saving it.
+				data.Clear();
+			});
+	}
+
+	void runShape(const char* name, const std::string& text)
+	{
+		const std::filesystem::path fileName = std::filesystem::temp_directory_path() / "CDataFileLoadBenchmark.ini";
+		{
+			std::ofstream file(fileName, std::ios::out | std::ios::trunc | std::ios::binary);
+			file.write(text.data(), static_cast<std::streamsize>(text.size()));
+		}
+
+		int blockKeys = 0;
+		int legacyKeys = 0;
+		const double blockNs = benchmarkLoad(fileName, blockKeys, [](CDataFile& data, const std::filesystem::path& path) { data.Load(path); });
+		const double legacyNs = benchmarkLoad(fileName, legacyKeys, [](CDataFile& data, const std::filesystem::path& path) { LegacyDataFileLoader::load(data, path); });
+		std::filesystem::remove(fileName);
+
+		std::printf("%10s %8.1f %10d %12.1f %12.1f %8.2fx%s\n", name, text.size() / (1024.0 * 1024.0), blockKeys,
+			blockNs / 1e6, legacyNs / 1e6, legacyNs / blockNs, blockKeys == legacyKeys ? "" : "  (key counts differ!)");
+	}
+}
+
+int main()
+{
+	std::printf("%10s %8s %10s %12s %12s %9s\n", "layout", "MB", "keys", "block ms", "getline ms", "speedup");
+	runShape("packed", LargeConfig::makePacked(400, 900));
+	runShape("per-key", LargeConfig::makePerKey(400, 350));
+	return 0;
+}
@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "CDataFile.h"
+#include "LegacyDataFileLoader.h"
+#include "TestSupport.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+using namespace ShaderTogglerTests;
+
+namespace
+{
+	// Exposes the parser and the parsed sections. Cleared on destruction, so a parsed model isn't saved.
+	class InspectableDataFile : public CDataFile
+	{
+	public:
+		~InspectableDataFile() override { Clear(); }
+
+		using CDataFile::ParseBuffer;
+		const SectionList& getSections() const { return m_Sections; }
+	};
+
+	std::filesystem::path testFilePath(const char* name)
+	{
+		return std::filesystem::temp_directory_path() / (std::string("CDataFileTests_") + name + ".ini");
+	}
+
+	void writeTextFile(const std::filesystem::path& fileName, std::string_view text)
+	{
+		std::ofstream file(fileName, std::ios::out | std::ios::trunc | std::ios::binary);
+		file.write(text.data(), static_cast<std::streamsize>(text.size()));
+	}
+
+	// Same sections in the same order, each with the same comment and the same keys, values and comments.
+	bool sameContents(const InspectableDataFile& a, const InspectableDataFile& b)
+	{
+		const SectionList& sectionsA = a.getSections();
+		const SectionList& sectionsB = b.getSections();
+		if (sectionsA.size() != sectionsB.size())
+			return false;
+
+		for (size_t i = 0; i < sectionsA.size(); ++i)
+		{
+			const t_Section& sectionA = sectionsA[i];
+			const t_Section& sectionB = sectionsB[i];
+			if (sectionA.szName != sectionB.szName || sectionA.szComment != sectionB.szComment || sectionA.Keys.size() != sectionB.Keys.size())
+				return false;
+
+			for (size_t k = 0; k < sectionA.Keys.size(); ++k)
+			{
+				const t_Key& keyA = sectionA.Keys[k];
+				const t_Key& keyB = sectionB.Keys[k];
+				if (keyA.szKey != keyB.szKey || keyA.szValue != keyB.szValue || keyA.szComment != keyB.szComment)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Both loaders on the same file must build the same model.
+	bool matchesLegacyLoader(const char* name, std::string_view text)
+	{
+		const std::filesystem::path fileName = testFilePath(name);
+		writeTextFile(fileName, text);
+
+		InspectableDataFile loaded;
+		InspectableDataFile legacy;
+		const bool bothLoaded = loaded.Load(fileName) && LegacyDataFileLoader::load(legacy, fileName);
+		std::filesystem::remove(fileName);
+		return bothLoaded && sameContents(loaded, legacy);
+	}
+
+	void testKeysAndSections()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("TopLevel=1\n[General]\nName=Group A\nCount = 12\n[Group0]\nToggleKey=20\n");
+
+		CHECK(data.GetValue("TopLevel") == "1");
+		CHECK(data.GetValue("Name", "General") == "Group A");
+		CHECK(data.GetInt("Count", "General") == 12);
+		CHECK(data.GetUInt("ToggleKey", "Group0") == 20);
+		// names are case-insensitive.
+		CHECK(data.GetValue("name", "GENERAL") == "Group A");
+		CHECK(data.SectionCount() == 3);
+		CHECK(data.KeyCount() == 4);
+	}
+
+	void testCrlfLineEndings()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("[General]\r\nName=Group A\r\nHashes=0000000A,0000000B\r\n\r\n[Other]\r\nKey=Value");
+
+		CHECK(data.GetValue("Name", "General") == "Group A");
+		CHECK(data.GetValue("Hashes", "General") == "0000000A,0000000B");
+		CHECK(data.GetArray("Hashes", "General").size() == 2);
+		CHECK(data.GetSectionKeys("Other") != nullptr);
+		CHECK(data.GetValue("Key", "Other") == "Value");
+
+		CHECK(matchesLegacyLoader("crlf", "; top\r\n[General]\r\nName=Group A\r\n;note\r\nCount=3\r\n"));
+	}
+
+	void testLastLineWithoutNewline()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("[General]\nFirst=1\nLast=2");
+		CHECK(data.GetInt("Last", "General") == 2);
+	}
+
+	void testLongLines()
+	{
+		std::string hashes;
+		for (int i = 0; i < 100000; ++i)
+		{
+			if (!hashes.empty())
+				hashes += ',';
+			char hash[9];
+			std::snprintf(hash, sizeof(hash), "%08X", i * 2654435761u);
+			hashes += hash;
+		}
+
+		const std::string text = "[GTGroup0]\nPixelShaderHashes=" + hashes + "\nName=Long\n";
+		InspectableDataFile data;
+		data.ParseBuffer(text);
+
+		CHECK(data.GetValue("PixelShaderHashes", "GTGroup0") == hashes);
+		CHECK(data.GetArray("PixelShaderHashes", "GTGroup0").size() == 100000);
+		CHECK(data.GetValue("Name", "GTGroup0") == "Long");
+		CHECK(matchesLegacyLoader("long", text));
+	}
+
+	void testDuplicateKeysKeepTheLastValue()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("[General]\nKey=1\nOther=x\nKEY=2\n");
+
+		CHECK(data.GetValue("Key", "General") == "2");
+		const KeyList* keys = data.GetSectionKeys("General");
+		CHECK(keys != nullptr && keys->size() == 2);
+		// the key stays where it first appeared, under its first spelling.
+		CHECK(keys != nullptr && keys->front().szKey == "Key");
+
+		CHECK(matchesLegacyLoader("duplicateKeys", "[General]\nKey=1\nOther=x\n;second\nKEY=2\n"));
+	}
+
+	void testDuplicateSectionsAreMerged()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("[A]\nx=1\n[B]\ny=2\n[a]\nz=3\nx=4\n");
+
+		CHECK(data.SectionCount() == 3);
+		CHECK(data.GetValue("x", "A") == "4");
+		CHECK(data.GetValue("z", "A") == "3");
+		CHECK(data.GetValue("y", "B") == "2");
+
+		CHECK(matchesLegacyLoader("duplicateSections", "[A]\nx=1\n[B]\ny=2\n; again\n[a]\nz=3\nx=4\n"));
+	}
+
+	void testComments()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("; file\n# header\n[General]\n; about the key\nKey=Value\n; dangling\n");
+
+		const SectionList& sections = data.getSections();
+		CHECK(sections.size() == 2);
+		CHECK(sections.size() == 2 && sections[1].szComment == "\n; file\n# header");
+		const KeyList* keys = data.GetSectionKeys("General");
+		CHECK(keys != nullptr && keys->size() == 1 && keys->front().szComment == "\n; about the key");
+		// a ';' inside a value is not a comment.
+		data.ParseBuffer("[General]\nUrl=a;b#c\n");
+		CHECK(data.GetValue("Url", "General") == "a;b#c");
+
+		CHECK(matchesLegacyLoader("comments", "; file\n# header\n[General]\n; about the key\nKey=Value\n; dangling\n"));
+	}
+
+	void testDelimitersAndWhitespace()
+	{
+		InspectableDataFile data;
+		data.ParseBuffer("[General]\n  Padded  =  spaced value  \nColon:value\nPath=C:\\Games=1\nEmpty=\nNoValue\n\t\n");
+
+		// the line is trimmed; the value keeps what follows the first delimiter.
+		CHECK(data.GetValue("Padded", "General") == "  spaced value");
+		CHECK(data.GetValue("Colon", "General") == "value");
+		CHECK(data.GetValue("Path", "General") == "C:\\Games=1");
+		CHECK(data.GetSectionKeys("General") != nullptr && data.GetSectionKeys("General")->size() == 3);
+
+		CHECK(matchesLegacyLoader("delimiters", "[General]\n  Padded  =  spaced value  \nColon:value\nPath=C:\\Games=1\nEmpty=\nNoValue\n\t\n"));
+	}
+
+	void testSaveAndLoadRoundTrip()
+	{
+		const std::filesystem::path fileName = testFilePath("roundTrip");
+		{
+			CDataFile data;
+			data.SetFileName(fileName);
+			data.SetHeader("; header line\n");
+			data.SetValue("Name", "Group A", "the group's name", "General");
+			data.SetInt("Count", -3, "", "General");
+			data.SetArray("Hashes", { 10, 11, 0xFFFFFFFE }, "", "GTGroup0");
+			data.SetSectionComment("GTGroup0", "first group");
+			CHECK(data.Save());
+			data.Clear();
+		}
+
+		InspectableDataFile loaded;
+		CHECK(loaded.Load(fileName));
+		CHECK(loaded.GetValue("Name", "General") == "Group A");
+		CHECK(loaded.GetInt("Count", "General") == -3);
+		const std::vector<uint32_t> hashes = loaded.GetArray("Hashes", "GTGroup0");
+		CHECK(hashes.size() == 3 && hashes[2] == 0xFFFFFFFE);
+		const KeyList* keys = loaded.GetSectionKeys("General");
+		CHECK(keys != nullptr && keys->front().szComment == "\n; the group's name");
+
+		// saving the loaded model and loading it again changes nothing.
+		loaded.SetFileName(fileName);
+		CHECK(loaded.Save());
+		InspectableDataFile reloaded;
+		CHECK(reloaded.Load(fileName));
+		CHECK(sameContents(loaded, reloaded));
+
+		std::filesystem::remove(fileName);
+	}
+
+	void testLoadMissingFile()
+	{
+		InspectableDataFile data;
+		CHECK(!data.Load(testFilePath("doesNotExist")));
+	}
+}
+
+int main()
+{
+	testKeysAndSections();
+	testCrlfLineEndings();
+	testLastLineWithoutNewline();
+	testLongLines();
+	testDuplicateKeysKeepTheLastValue();
+	testDuplicateSectionsAreMerged();
+	testComments();
+	testDelimitersAndWhitespace();
+	testSaveAndLoadRoundTrip();
+	testLoadMissingFile();
+	return finishTests("CDataFileTests");
+}
@@ -0,0 +1,344 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "GamepadPoller.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace ShaderToggler;
+
+namespace
+{
+	// Backend with a scripted controller state; the test thread sets it while the poller thread reads it.
+	class FakeGamepadBackend : public GamepadPollingBackend
+	{
+	public:
+		bool pollDownCodes(GamepadCodeMask& downCodes) override
+		{
+			pollCount.fetch_add(1, std::memory_order_relaxed);
+			if (!connected.load(std::memory_order_relaxed))
+			{
+				downCodes = 0;
+				return false;
+			}
+			downCodes = down.load(std::memory_order_relaxed);
+			return true;
+		}
+
+		bool detectPlayStationController() override
+		{
+			detectCount.fetch_add(1, std::memory_order_relaxed);
+			return playStation.load(std::memory_order_relaxed);
+		}
+
+		std::atomic_bool connected = true;
+		std::atomic<GamepadCodeMask> down = 0;
+		std::atomic_bool playStation = false;
+		std::atomic_uint32_t pollCount = 0;
+		std::atomic_uint32_t detectCount = 0;
+	};
+
+	constexpr GamepadCodeMask ButtonA = 1 << 0;
+	constexpr GamepadCodeMask ButtonB = 1 << 1;
+	constexpr GamepadCodeMask ButtonStart = 1 << 9;
+
+	template <typename Condition>
+	bool waitFor(Condition&& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000))
+	{
+		const auto giveUpAt = std::chrono::steady_clock::now() + timeout;
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > giveUpAt)
+				return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	void testPollPublishesPreviousAndCurrent()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		backend.down = ButtonA;
+		poller.pollOnce(backend);
+		backend.down = ButtonA | ButtonB;
+		poller.pollOnce(backend);
+
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		poller.readDownCodes(previous, current);
+		CHECK(previous == ButtonA);
+		CHECK(current == (ButtonA | ButtonB));
+	}
+
+	void testPressedEdgesAccumulateUntilTaken()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		// A is tapped between two frames, B is pressed and held.
+		backend.down = ButtonA;
+		poller.pollOnce(backend);
+		backend.down = 0;
+		poller.pollOnce(backend);
+		backend.down = ButtonB;
+		poller.pollOnce(backend);
+		poller.pollOnce(backend);
+
+		CHECK(poller.takePressedCodes() == (ButtonA | ButtonB));
+		CHECK(poller.takePressedCodes() == 0);
+
+		// holding B is not a new press, pressing it again is.
+		poller.pollOnce(backend);
+		CHECK(poller.takePressedCodes() == 0);
+		backend.down = 0;
+		poller.pollOnce(backend);
+		backend.down = ButtonB;
+		poller.pollOnce(backend);
+		CHECK(poller.takePressedCodes() == ButtonB);
+	}
+
+	void testDisconnectReleasesEverything()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		backend.down = ButtonStart;
+		poller.pollOnce(backend);
+		backend.connected = false;
+		poller.pollOnce(backend);
+
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		poller.readDownCodes(previous, current);
+		CHECK(previous == ButtonStart);
+		CHECK(current == 0);
+
+		// reconnecting with the button still held counts as a press.
+		poller.takePressedCodes();
+		backend.connected = true;
+		poller.pollOnce(backend);
+		CHECK(poller.takePressedCodes() == ButtonStart);
+	}
+
+	void testDetect()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		backend.playStation = true;
+		poller.detectOnce(backend);
+		CHECK(poller.isPlayStationControllerDetected());
+		backend.playStation = false;
+		poller.detectOnce(backend);
+		CHECK(!poller.isPlayStationControllerDetected());
+	}
+
+	void testStartPublishesFirstStateWithoutPresses()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		backend.down = ButtonA;
+		backend.playStation = true;
+		poller.start(backend, 1000, 60000);
+		CHECK(poller.isRunning());
+		CHECK(poller.isPlayStationControllerDetected());
+
+		// a button already held when polling starts is down, but was not pressed.
+		GamepadCodeMask previous = 0;
+		GamepadCodeMask current = 0;
+		poller.readDownCodes(previous, current);
+		CHECK(current == ButtonA);
+		CHECK(poller.takePressedCodes() == 0);
+
+		poller.stop();
+		CHECK(!poller.isRunning());
+	}
+
+	void testThreadPollsAtInterval()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		poller.start(backend, 2, 60000);
+		const uint32_t pollsAtStart = backend.pollCount;
+		CHECK(waitFor([&] { return backend.pollCount >= pollsAtStart + 10; }));
+
+		// a press made while the thread runs shows up without any call from the "present" side.
+		poller.takePressedCodes();
+		backend.down = ButtonB;
+		CHECK(waitFor([&] { return (poller.takePressedCodes() & ButtonB) != 0; }));
+
+		// a long interval stops the polling for now.
+		poller.setPollIntervalMs(60000);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const uint32_t pollsAfterSlowdown = backend.pollCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(backend.pollCount <= pollsAfterSlowdown + 1);
+
+		poller.stop();
+	}
+
+	void testIntervalIsAtLeastOneMs()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		poller.start(backend, 0, 0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		poller.stop();
+
+		// 0 would spin; clamped to 1 ms the thread polls at most about 50 times here.
+		CHECK(backend.pollCount >= 2);
+		CHECK(backend.pollCount <= 60);
+	}
+
+	void testStopWakesTheThreadAndEndsPolling()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+
+		poller.start(backend, 60000, 60000);
+		const auto stopStart = std::chrono::steady_clock::now();
+		poller.stop();
+		const auto stopTime = std::chrono::steady_clock::now() - stopStart;
+		CHECK(stopTime < std::chrono::milliseconds(1000));
+		CHECK(!poller.isRunning());
+
+		const uint32_t pollsAfterStop = backend.pollCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(backend.pollCount == pollsAfterStop);
+
+		// stopping twice is harmless, and a stopped poller starts again.
+		poller.stop();
+		poller.start(backend, 1, 60000);
+		CHECK(poller.isRunning());
+		CHECK(waitFor([&] { return backend.pollCount > pollsAfterStop + 2; }));
+		poller.stop();
+	}
+
+	void testSecondStartIsIgnored()
+	{
+		FakeGamepadBackend first;
+		FakeGamepadBackend second;
+		GamepadPoller poller;
+
+		poller.start(first, 1, 60000);
+		poller.start(second, 1, 60000);
+		CHECK(waitFor([&] { return first.pollCount > 5; }));
+		poller.stop();
+		CHECK(second.pollCount == 0);
+	}
+
+	// Backend whose polls block once blocking is switched on, standing in for a thread that can't run anymore.
+	class BlockingGamepadBackend : public GamepadPollingBackend
+	{
+	public:
+		bool pollDownCodes(GamepadCodeMask& downCodes) override
+		{
+			if (blocking.load(std::memory_order_relaxed))
+			{
+				blocked = true;
+				std::unique_lock<std::mutex> lock(_mutex);
+				_neverSignaled.wait(lock, [] { return false; });
+			}
+			downCodes = 0;
+			return false;
+		}
+
+		bool detectPlayStationController() override { return false; }
+
+		std::atomic_bool blocking = false;
+		std::atomic_bool blocked = false;
+
+	private:
+		std::mutex _mutex;
+		std::condition_variable _neverSignaled;
+	};
+
+	void testDestructorDoesNotWaitForTheThread()
+	{
+		// leaked on purpose: the blocked thread keeps using it until the process exits.
+		BlockingGamepadBackend* backend = new BlockingGamepadBackend();
+		auto* poller = new GamepadPoller();
+		poller->start(*backend, 1, 60000);
+		backend->blocking = true;
+		CHECK(waitFor([&] { return backend->blocked.load(); }));
+
+		const auto destroyStart = std::chrono::steady_clock::now();
+		delete poller;
+		CHECK(std::chrono::steady_clock::now() - destroyStart < std::chrono::milliseconds(1000));
+	}
+
+	void testAbandonEndsAnIdleThread()
+	{
+		FakeGamepadBackend backend;
+		GamepadPoller poller;
+		poller.start(backend, 1, 60000);
+		CHECK(waitFor([&] { return backend.pollCount > 2; }));
+
+		poller.abandon();
+		CHECK(!poller.isRunning());
+		// the detached thread sees the stop request at its next wakeup.
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const uint32_t pollsAfterAbandon = backend.pollCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(backend.pollCount == pollsAfterAbandon);
+	}
+}
+
+int main()
+{
+	testPollPublishesPreviousAndCurrent();
+	testPressedEdgesAccumulateUntilTaken();
+	testDisconnectReleasesEverything();
+	testDetect();
+	testStartPublishesFirstStateWithoutPresses();
+	testThreadPollsAtInterval();
+	testIntervalIsAtLeastOneMs();
+	testStopWakesTheThreadAndEndsPolling();
+	testSecondStartIsIgnored();
+	testAbandonEndsAnIdleThread();
+	testDestructorDoesNotWaitForTheThread();
+	return ShaderTogglerTests::finishTests("GamepadPollerTests");
+}
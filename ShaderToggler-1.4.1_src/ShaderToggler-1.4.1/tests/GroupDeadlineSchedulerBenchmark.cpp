@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// Per-frame cost of the present loop's deadline handling, driven by a fake clock at 60 fps. Each frame a number
+// of groups get a new deadline (a key edge or an expired timer) and the expired ones are popped. The scan column
+// is the loop the scheduler replaced: every group's deadline is checked every frame.
+
+#include "GroupDeadlineScheduler.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ShaderToggler;
+using TimePoint = GroupDeadlineScheduler::TimePoint;
+
+namespace
+{
+	TimePoint s_fakeNow;
+
+	TimePoint fakeNow()
+	{
+		return s_fakeNow;
+	}
+
+	constexpr int FrameCount = 20000;
+	constexpr auto FrameTime = std::chrono::microseconds(16667);
+
+	struct DeadlineEvent
+	{
+		uint32_t slot;
+		std::chrono::milliseconds delay;
+	};
+
+	// Generated up front so the timed loops only measure the deadline handling.
+	std::vector<DeadlineEvent> makeEvents(uint32_t groupCount, uint32_t eventsPerFrame)
+	{
+		std::mt19937 random(groupCount * 31 + eventsPerFrame);
+		std::uniform_int_distribution<uint32_t> slotDistribution(0, groupCount - 1);
+		std::uniform_int_distribution<int> delayDistribution(1, 500);
+
+		std::vector<DeadlineEvent> events(static_cast<size_t>(FrameCount) * eventsPerFrame);
+		for (DeadlineEvent& event : events)
+			event = { slotDistribution(random), std::chrono::milliseconds(delayDistribution(random)) };
+		return events;
+	}
+
+	double benchmarkScheduler(uint32_t groupCount, uint32_t eventsPerFrame)
+	{
+		const std::vector<DeadlineEvent> events = makeEvents(groupCount, eventsPerFrame);
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(groupCount);
+		s_fakeNow = TimePoint();
+		uint64_t expiredCount = 0;
+
+		const double ns = ShaderTogglerTests::measureNsPerIteration(FrameCount, [&](int frame)
+			{
+				s_fakeNow += FrameTime;
+				scheduler.popExpired(scheduler.now(), [&](uint32_t) { ++expiredCount; });
+				for (uint32_t i = 0; i < eventsPerFrame; ++i)
+				{
+					const DeadlineEvent& event = events[static_cast<size_t>(frame) * eventsPerFrame + i];
+					scheduler.schedule(event.slot, s_fakeNow + event.delay);
+				}
+			});
+
+		return expiredCount > 0 ? ns : -1.0;
+	}
+
+	double benchmarkScan(uint32_t groupCount, uint32_t eventsPerFrame)
+	{
+		const std::vector<DeadlineEvent> events = makeEvents(groupCount, eventsPerFrame);
+		std::vector<TimePoint> deadlines(groupCount, TimePoint::max());
+		s_fakeNow = TimePoint();
+		uint64_t expiredCount = 0;
+
+		const double ns = ShaderTogglerTests::measureNsPerIteration(FrameCount, [&](int frame)
+			{
+				s_fakeNow += FrameTime;
+				for (TimePoint& deadline : deadlines)
+				{
+					if (deadline <= s_fakeNow)
+					{
+						deadline = TimePoint::max();
+						++expiredCount;
+					}
+				}
+				for (uint32_t i = 0; i < eventsPerFrame; ++i)
+				{
+					const DeadlineEvent& event = events[static_cast<size_t>(frame) * eventsPerFrame + i];
+					deadlines[event.slot] = s_fakeNow + event.delay;
+				}
+			});
+
+		return expiredCount > 0 ? ns : -1.0;
+	}
+}
+
+int main()
+{
+	std::printf("%8s %8s %16s %16s\n", "groups", "events", "scheduler ns", "scan ns");
+	for (const uint32_t groupCount : { 16u, 256u, 4096u, 65536u })
+	{
+		for (const uint32_t eventsPerFrame : { 1u, 16u })
+		{
+			std::printf("%8u %8u %16.1f %16.1f\n", groupCount, eventsPerFrame,
+				benchmarkScheduler(groupCount, eventsPerFrame), benchmarkScan(groupCount, eventsPerFrame));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "GroupDeadlineScheduler.h"
+#include "TestSupport.h"
+#include <vector>
+
+using namespace ShaderToggler;
+using TimePoint = GroupDeadlineScheduler::TimePoint;
+
+namespace
+{
+	TimePoint s_fakeNow;
+
+	TimePoint fakeNow()
+	{
+		return s_fakeNow;
+	}
+
+	TimePoint at(int ms)
+	{
+		return TimePoint() + std::chrono::milliseconds(ms);
+	}
+
+	std::vector<uint32_t> popExpiredAt(GroupDeadlineScheduler& scheduler, int ms)
+	{
+		s_fakeNow = at(ms);
+		std::vector<uint32_t> expired;
+		scheduler.popExpired(scheduler.now(), [&](uint32_t slot) { expired.push_back(slot); });
+		return expired;
+	}
+
+	void testUsesInjectedClock()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		s_fakeNow = at(1234);
+		CHECK(scheduler.now() == at(1234));
+	}
+
+	void testExpiresInDeadlineOrder()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(4);
+		scheduler.schedule(2, at(300));
+		scheduler.schedule(0, at(100));
+		scheduler.schedule(3, at(200));
+		CHECK(scheduler.getPendingCount() == 3);
+
+		CHECK(popExpiredAt(scheduler, 99).empty());
+		CHECK(popExpiredAt(scheduler, 250) == (std::vector<uint32_t>{ 0, 3 }));
+		CHECK(!scheduler.isScheduled(0));
+		CHECK(scheduler.isScheduled(2));
+		CHECK(popExpiredAt(scheduler, 300) == (std::vector<uint32_t>{ 2 }));
+		CHECK(scheduler.getPendingCount() == 0);
+	}
+
+	void testEqualDeadlinesAllExpire()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(3);
+		scheduler.schedule(0, at(50));
+		scheduler.schedule(1, at(50));
+		scheduler.schedule(2, at(50));
+		CHECK(popExpiredAt(scheduler, 50).size() == 3);
+	}
+
+	void testRescheduleReplacesDeadline()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(2);
+		scheduler.schedule(1, at(100));
+		scheduler.schedule(1, at(500));
+		CHECK(scheduler.getPendingCount() == 1);
+
+		// the entry for 100 ms is stale and must not fire.
+		CHECK(popExpiredAt(scheduler, 100).empty());
+		CHECK(popExpiredAt(scheduler, 500) == (std::vector<uint32_t>{ 1 }));
+
+		scheduler.schedule(1, at(900));
+		scheduler.schedule(1, at(600));
+		CHECK(popExpiredAt(scheduler, 600) == (std::vector<uint32_t>{ 1 }));
+		CHECK(popExpiredAt(scheduler, 900).empty());
+	}
+
+	void testCancel()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(2);
+		scheduler.schedule(0, at(100));
+		scheduler.schedule(1, at(100));
+		scheduler.cancel(0);
+		scheduler.cancel(0);
+		CHECK(scheduler.getPendingCount() == 1);
+		CHECK(popExpiredAt(scheduler, 100) == (std::vector<uint32_t>{ 1 }));
+
+		// scheduling at TimePoint::max() is a cancel as well.
+		scheduler.schedule(0, at(200));
+		scheduler.schedule(0, TimePoint::max());
+		CHECK(!scheduler.isScheduled(0));
+		CHECK(popExpiredAt(scheduler, 200).empty());
+	}
+
+	void testOutOfRangeSlotsAreIgnored()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(1);
+		scheduler.schedule(5, at(10));
+		scheduler.cancel(5);
+		CHECK(!scheduler.isScheduled(5));
+		CHECK(scheduler.getPendingCount() == 0);
+		CHECK(popExpiredAt(scheduler, 10).empty());
+	}
+
+	void testResetDropsDeadlines()
+	{
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(2);
+		scheduler.schedule(0, at(10));
+		scheduler.reset(2);
+		CHECK(scheduler.getPendingCount() == 0);
+		CHECK(popExpiredAt(scheduler, 10).empty());
+	}
+
+	void testRescheduleEveryFrameStaysCorrect()
+	{
+		// a held trigger key pushes the deadline out every frame, which leaves a stale entry per frame.
+		GroupDeadlineScheduler scheduler(&fakeNow);
+		scheduler.reset(8);
+		scheduler.schedule(7, at(5000));
+		int lastDeadline = 0;
+		for (int frame = 0; frame < 2000; ++frame)
+		{
+			CHECK(popExpiredAt(scheduler, frame).empty());
+			lastDeadline = frame + 250;
+			scheduler.schedule(3, at(lastDeadline));
+		}
+
+		CHECK(scheduler.getPendingCount() == 2);
+		CHECK(popExpiredAt(scheduler, lastDeadline - 1).empty());
+		CHECK(popExpiredAt(scheduler, lastDeadline) == (std::vector<uint32_t>{ 3 }));
+		CHECK(popExpiredAt(scheduler, 5000) == (std::vector<uint32_t>{ 7 }));
+	}
+}
+
+int main()
+{
+	testUsesInjectedClock();
+	testExpiresInDeadlineOrder();
+	testEqualDeadlinesAllExpire();
+	testRescheduleReplacesDeadline();
+	testCancel();
+	testOutOfRangeSlotsAreIgnored();
+	testResetDropsDeadlines();
+	testRescheduleEveryFrameStaysCorrect();
+	return ShaderTogglerTests::finishTests("GroupDeadlineSchedulerTests");
+}
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace ShaderTogglerTests
+{
+	// Generated INI text in the layouts the add-on writes, for the loader benchmarks. Hashes are spread
+	// deterministically so every run loads the same file.
+	namespace LargeConfig
+	{
+		inline uint32_t hashAt(size_t group, size_t stage, size_t index)
+		{
+			return static_cast<uint32_t>((group * 7919 + stage * 104729 + index) * 2654435761u);
+		}
+
+		inline void appendGroupSettings(std::string& text, size_t group)
+		{
+			char line[96];
+			std::snprintf(line, sizeof(line), "Name=Group %zu\n", group);
+			text += line;
+			text +=
+				"Notice=\n"
+				"ToggleKey=20\n"
+				"IsActiveAtStartup=0\n"
+				"StartupTimed=0\n"
+				"StartupDurationMs=30000\n"
+				"HoldMode=0\n"
+				"HoldInverted=0\n"
+				"TimedMode=0\n"
+				"TimedModeInverted=0\n"
+				"TimedModeDelayMs=1500\n"
+				"TimedModeMinVisibleMs=250\n"
+				"TimedModeFadeOutMs=150\n"
+				"TimedSuppressionLingerMs=250\n";
+		}
+
+		inline void appendGeneral(std::string& text, size_t groupCount, int groupFormat)
+		{
+			char line[96];
+			text += "; ShaderToggler Advanced configuration\n[General]\nCreator=ShaderToggler Advanced\n";
+			std::snprintf(line, sizeof(line), "GTAmountGroups=%zu\nGTGroupFormat=%d\n", groupCount, groupFormat);
+			text += line;
+		}
+
+		// The current layout: one comma separated list of 8-digit hex values per stage.
+		inline std::string makePacked(size_t groupCount, size_t hashesPerStage)
+		{
+			static const char* stageKeys[] = { "VertexShaderHashes", "PixelShaderHashes", "ComputeShaderHashes" };
+
+			std::string text;
+			text.reserve(groupCount * (3 * (hashesPerStage * 9 + 24) + 320) + 256);
+			appendGeneral(text, groupCount, 2);
+
+			char hash[16];
+			for (size_t group = 0; group < groupCount; ++group)
+			{
+				text += "\n[GTGroup" + std::to_string(group) + "]\n";
+				for (size_t stage = 0; stage < 3; ++stage)
+				{
+					text += stageKeys[stage];
+					text += '=';
+					for (size_t i = 0; i < hashesPerStage; ++i)
+					{
+						std::snprintf(hash, sizeof(hash), i == 0 ? "%08X" : ",%08X", hashAt(group, stage, i));
+						text += hash;
+					}
+					text += '\n';
+				}
+				appendGroupSettings(text, group);
+			}
+			return text;
+		}
+
+		// The layout before packed lists: a section per stage with one decimal ShaderHash<n> key per hash.
+		inline std::string makePerKey(size_t groupCount, size_t hashesPerStage)
+		{
+			static const char* stageSections[] = { "_VertexShaders", "_PixelShaders", "_ComputeShaders" };
+
+			std::string text;
+			text.reserve(groupCount * (3 * (hashesPerStage * 26 + 48) + 320) + 256);
+			appendGeneral(text, groupCount, 1);
+
+			char line[64];
+			for (size_t group = 0; group < groupCount; ++group)
+			{
+				std::snprintf(line, sizeof(line), "\n[GTGroup%zu]\n", group);
+				text += line;
+				appendGroupSettings(text, group);
+
+				for (size_t stage = 0; stage < 3; ++stage)
+				{
+					std::snprintf(line, sizeof(line), "\n[GTGroup%zu%s]\nAmountHashes=%zu\n", group, stageSections[stage], hashesPerStage);
+					text += line;
+					for (size_t i = 0; i < hashesPerStage; ++i)
+					{
+						std::snprintf(line, sizeof(line), "ShaderHash%zu=%u\n", i, hashAt(group, stage, i));
+						text += line;
+					}
+				}
+			}
+			return text;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CDataFile.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace ShaderTogglerTests
+{
+	// The getline loop CDataFile::Load used before it parsed the file as one block: every line is read into a
+	// string and trimmed, and every key goes through SetValue. Kept as the reference the block parser is
+	// compared against, in the tests and the loader benchmark.
+	namespace LegacyDataFileLoader
+	{
+		inline void trim(std::string& text)
+		{
+			const std::string trimChars = WhiteSpace + EqualIndicators;
+			const size_t first = text.find_first_not_of(trimChars);
+			if (first == std::string::npos)
+			{
+				text.clear();
+				return;
+			}
+			text = text.substr(first, text.find_last_not_of(trimChars) - first + 1);
+		}
+
+		inline std::string nextWord(std::string& line)
+		{
+			const size_t delimiter = line.find_first_of(EqualIndicators);
+			std::string word;
+			if (delimiter != std::string::npos)
+			{
+				word = line.substr(0, delimiter);
+				line.erase(0, delimiter + 1);
+			}
+			else
+			{
+				word = line;
+				line.clear();
+			}
+			trim(word);
+			return word;
+		}
+
+		inline bool load(CDataFile& dataFile, const std::filesystem::path& fileName)
+		{
+			std::fstream file(fileName, std::ios::in);
+			if (!file.is_open())
+				return false;
+
+			std::string line;
+			std::string comment;
+			std::string sectionName;
+			bool done = false;
+			while (!done)
+			{
+				std::getline(file, line);
+				trim(line);
+
+				done = file.eof() || file.bad() || file.fail();
+
+				if (line.find_first_of(CommentIndicators) == 0)
+				{
+					comment += "\n";
+					comment += line;
+				}
+				else if (line.find_first_of('[') == 0)
+				{
+					line.erase(0, 1);
+					const size_t close = line.find_last_of(']');
+					if (close != std::string::npos)
+						line.erase(close, 1);
+
+					dataFile.CreateSection(line, comment);
+					sectionName = line;
+					comment.clear();
+				}
+				else if (!line.empty())
+				{
+					const std::string key = nextWord(line);
+					if (!key.empty() && !line.empty())
+					{
+						dataFile.SetValue(key, line, comment, sectionName);
+						comment.clear();
+					}
+				}
+			}
+			return true;
+		}
+	}
+}
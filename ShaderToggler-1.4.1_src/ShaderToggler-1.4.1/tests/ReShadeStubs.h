@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <reshade.hpp>
+#include <array>
+#include <unordered_map>
+
+// Minimal ReShade objects for driving the add-on's event callbacks on Linux. Private data, the owning device and
+// the keyboard state work; every other call does nothing and returns an empty value.
+namespace ShaderTogglerTests
+{
+	using namespace reshade::api;
+
+	template <typename Interface>
+	class StubApiObject : public Interface
+	{
+	public:
+		uint64_t get_native() const override { return 0; }
+
+		// __uuidof gives every type its own static GUID object, so its address is the key.
+		void get_private_data(const uint8_t guid[16], uint64_t* data) const override
+		{
+			const auto entry = _privateData.find(guid);
+			*data = entry == _privateData.end() ? 0 : entry->second;
+		}
+		void set_private_data(const uint8_t guid[16], const uint64_t data) override
+		{
+			if (data == 0)
+				_privateData.erase(guid);
+			else
+				_privateData[guid] = data;
+		}
+
+	private:
+		std::unordered_map<const uint8_t*, uint64_t> _privateData;
+	};
+
+	class StubDevice final : public StubApiObject<device>
+	{
+	public:
+		device_api get_api() const override { return device_api::d3d11; }
+
+		bool check_capability(device_caps capability) const override { return {}; }
+		bool check_format_support(format format, resource_usage usage) const override { return {}; }
+		bool create_sampler(const sampler_desc &desc, sampler *out_handle) override { return {}; }
+		void destroy_sampler(sampler handle) override { }
+		bool create_resource(const resource_desc &desc, const subresource_data *initial_data, resource_usage initial_state, resource *out_handle, void **shared_handle) override { return {}; }
+		void destroy_resource(resource handle) override { }
+		resource_desc get_resource_desc(resource resource) const override { return {}; }
+		bool create_resource_view(resource resource, resource_usage usage_type, const resource_view_desc &desc, resource_view *out_handle) override { return {}; }
+		void destroy_resource_view(resource_view handle) override { }
+		resource get_resource_from_view(resource_view view) const override { return {}; }
+		resource_view_desc get_resource_view_desc(resource_view view) const override { return {}; }
+		bool map_buffer_region(resource resource, uint64_t offset, uint64_t size, map_access access, void **out_data) override { return {}; }
+		void unmap_buffer_region(resource resource) override { }
+		bool map_texture_region(resource resource, uint32_t subresource, const subresource_box *box, map_access access, subresource_data *out_data) override { return {}; }
+		void unmap_texture_region(resource resource, uint32_t subresource) override { }
+		void update_buffer_region(const void *data, resource resource, uint64_t offset, uint64_t size) override { }
+		void update_texture_region(const subresource_data &data, resource resource, uint32_t subresource, const subresource_box *box) override { }
+		bool create_pipeline(pipeline_layout layout, uint32_t subobject_count, const pipeline_subobject *subobjects, pipeline *out_handle) override { return {}; }
+		void destroy_pipeline(pipeline handle) override { }
+		bool create_pipeline_layout(uint32_t param_count, const pipeline_layout_param *params, pipeline_layout *out_handle) override { return {}; }
+		void destroy_pipeline_layout(pipeline_layout handle) override { }
+		bool allocate_descriptor_sets(uint32_t count, pipeline_layout layout, uint32_t param, descriptor_set *out_handles) override { return {}; }
+		void free_descriptor_sets(uint32_t count, const descriptor_set *handles) override { }
+		void get_descriptor_pool_offset(descriptor_set set, uint32_t binding, uint32_t array_offset, descriptor_pool *out_pool, uint32_t *out_offset) const override { }
+		void copy_descriptor_sets(uint32_t count, const descriptor_set_copy *copies) override { }
+		void update_descriptor_sets(uint32_t count, const descriptor_set_update *updates) override { }
+		bool create_query_pool(query_type type, uint32_t size, query_pool *out_handle) override { return {}; }
+		void destroy_query_pool(query_pool handle) override { }
+		bool get_query_pool_results(query_pool pool, uint32_t first, uint32_t count, void *results, uint32_t stride) override { return {}; }
+		void set_resource_name(resource handle, const char *name) override { }
+		void set_resource_view_name(resource_view handle, const char *name) override { }
+	};
+
+	class StubCommandList final : public StubApiObject<command_list>
+	{
+	public:
+		explicit StubCommandList(device* owner) : _device(owner) {}
+
+		device* get_device() override { return _device; }
+
+		void barrier(uint32_t count, const resource *resources, const resource_usage *old_states, const resource_usage *new_states) override { }
+		void begin_render_pass(uint32_t count, const render_pass_render_target_desc *rts, const render_pass_depth_stencil_desc *ds) override { }
+		void end_render_pass() override { }
+		void bind_render_targets_and_depth_stencil(uint32_t count, const resource_view *rtvs, resource_view dsv) override { }
+		void bind_pipeline(pipeline_stage stages, pipeline pipeline) override { }
+		void bind_pipeline_states(uint32_t count, const dynamic_state *states, const uint32_t *values) override { }
+		void bind_viewports(uint32_t first, uint32_t count, const viewport *viewports) override { }
+		void bind_scissor_rects(uint32_t first, uint32_t count, const rect *rects) override { }
+		void push_constants(shader_stage stages, pipeline_layout layout, uint32_t param, uint32_t first, uint32_t count, const void *values) override { }
+		void push_descriptors(shader_stage stages, pipeline_layout layout, uint32_t param, const descriptor_set_update &update) override { }
+		void bind_descriptor_sets(shader_stage stages, pipeline_layout layout, uint32_t first, uint32_t count, const descriptor_set *sets) override { }
+		void bind_index_buffer(resource buffer, uint64_t offset, uint32_t index_size) override { }
+		void bind_vertex_buffers(uint32_t first, uint32_t count, const resource *buffers, const uint64_t *offsets, const uint32_t *strides) override { }
+		void bind_stream_output_buffers(uint32_t first, uint32_t count, const resource *buffers, const uint64_t *offsets, const uint64_t *max_sizes) override { }
+		void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override { }
+		void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) override { }
+		void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) override { }
+		void draw_or_dispatch_indirect(indirect_command type, resource buffer, uint64_t offset, uint32_t draw_count, uint32_t stride) override { }
+		void copy_resource(resource source, resource dest) override { }
+		void copy_buffer_region(resource source, uint64_t source_offset, resource dest, uint64_t dest_offset, uint64_t size) override { }
+		void copy_buffer_to_texture(resource source, uint64_t source_offset, uint32_t row_length, uint32_t slice_height, resource dest, uint32_t dest_subresource, const subresource_box *dest_box) override { }
+		void copy_texture_region(resource source, uint32_t source_subresource, const subresource_box *source_box, resource dest, uint32_t dest_subresource, const subresource_box *dest_box, filter_mode filter) override { }
+		void copy_texture_to_buffer(resource source, uint32_t source_subresource, const subresource_box *source_box, resource dest, uint64_t dest_offset, uint32_t row_length, uint32_t slice_height) override { }
+		void resolve_texture_region(resource source, uint32_t source_subresource, const subresource_box *source_box, resource dest, uint32_t dest_subresource, int32_t dest_x, int32_t dest_y, int32_t dest_z, format format) override { }
+		void clear_depth_stencil_view(resource_view dsv, const float *depth, const uint8_t *stencil, uint32_t rect_count, const rect *rects) override { }
+		void clear_render_target_view(resource_view rtv, const float color[4], uint32_t rect_count, const rect *rects) override { }
+		void clear_unordered_access_view_uint(resource_view uav, const uint32_t values[4], uint32_t rect_count, const rect *rects) override { }
+		void clear_unordered_access_view_float(resource_view uav, const float values[4], uint32_t rect_count, const rect *rects) override { }
+		void generate_mipmaps(resource_view srv) override { }
+		void begin_query(query_pool pool, query_type type, uint32_t index) override { }
+		void end_query(query_pool pool, query_type type, uint32_t index) override { }
+		void copy_query_pool_results(query_pool pool, query_type type, uint32_t first, uint32_t count, resource dest, uint64_t dest_offset, uint32_t stride) override { }
+		void begin_debug_event(const char *label, const float color[4]) override { }
+		void end_debug_event() override { }
+		void insert_debug_marker(const char *label, const float color[4]) override { }
+
+	private:
+		device* _device;
+	};
+
+	class StubEffectRuntime final : public StubApiObject<effect_runtime>
+	{
+	public:
+		explicit StubEffectRuntime(device* owner) : _device(owner) {}
+
+		device* get_device() override { return _device; }
+
+		// Pressed is only true for the frame after setKeyDown changed a key from up to down.
+		void setKeyDown(uint32_t keycode, bool down)
+		{
+			_pressed[keycode] = down && !_down[keycode];
+			_down[keycode] = down;
+		}
+		void endFrame() { _pressed.fill(false); }
+
+		bool is_key_down(uint32_t keycode) const override { return keycode < _down.size() && _down[keycode]; }
+		bool is_key_pressed(uint32_t keycode) const override { return keycode < _pressed.size() && _pressed[keycode]; }
+
+		void * get_hwnd() const override { return {}; }
+		void render_effects(command_list *cmd_list, resource_view rtv, resource_view rtv_srgb) override { }
+		void update_texture_bindings(const char *semantic, resource_view srv, resource_view srv_srgb) override { }
+		resource get_back_buffer(uint32_t index) override { return {}; }
+		uint32_t get_back_buffer_count() const override { return {}; }
+		uint32_t get_current_back_buffer_index() const override { return {}; }
+		command_queue *get_command_queue() override { return {}; }
+		bool capture_screenshot(uint8_t *pixels) override { return {}; }
+		void get_screenshot_width_and_height(uint32_t *out_width, uint32_t *out_height) const override { }
+		bool is_key_released(uint32_t keycode) const override { return {}; }
+		bool is_mouse_button_down(uint32_t button) const override { return {}; }
+		bool is_mouse_button_pressed(uint32_t button) const override { return {}; }
+		bool is_mouse_button_released(uint32_t button) const override { return {}; }
+		void get_mouse_cursor_position(uint32_t *out_x, uint32_t *out_y, int16_t *out_wheel_delta) const override { }
+		void enumerate_uniform_variables(const char *effect_name, void(*callback)(effect_runtime *runtime, effect_uniform_variable variable, void *user_data), void *user_data) override { }
+		effect_uniform_variable find_uniform_variable(const char *effect_name, const char *variable_name) const override { return {}; }
+		void get_uniform_variable_type(effect_uniform_variable variable, format *out_base_type, uint32_t *out_rows, uint32_t *out_columns, uint32_t *out_array_length) const override { }
+		void get_uniform_variable_name(effect_uniform_variable variable, char *name, size_t *length) const override { }
+		bool get_annotation_bool_from_uniform_variable(effect_uniform_variable variable, const char *name, bool *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_float_from_uniform_variable(effect_uniform_variable variable, const char *name, float *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_int_from_uniform_variable(effect_uniform_variable variable, const char *name, int32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_uint_from_uniform_variable(effect_uniform_variable variable, const char *name, uint32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_string_from_uniform_variable(effect_uniform_variable variable, const char *name, char *value, size_t *length) const override { return {}; }
+		void get_uniform_value_bool(effect_uniform_variable variable, bool *values, size_t count, size_t array_index) const override { }
+		void get_uniform_value_float(effect_uniform_variable variable, float *values, size_t count, size_t array_index) const override { }
+		void get_uniform_value_int(effect_uniform_variable variable, int32_t *values, size_t count, size_t array_index) const override { }
+		void get_uniform_value_uint(effect_uniform_variable variable, uint32_t *values, size_t count, size_t array_index) const override { }
+		void set_uniform_value_bool(effect_uniform_variable variable, const bool *values, size_t count, size_t array_index) override { }
+		void set_uniform_value_float(effect_uniform_variable variable, const float *values, size_t count, size_t array_index) override { }
+		void set_uniform_value_int(effect_uniform_variable variable, const int32_t *values, size_t count, size_t array_index) override { }
+		void set_uniform_value_uint(effect_uniform_variable variable, const uint32_t *values, size_t count, size_t array_index) override { }
+		void enumerate_texture_variables(const char *effect_name, void(*callback)(effect_runtime *runtime, effect_texture_variable variable, void *user_data), void *user_data) override { }
+		effect_texture_variable find_texture_variable(const char *effect_name, const char *variable_name) const override { return {}; }
+		void get_texture_variable_name(effect_texture_variable variable, char *name, size_t *length) const override { }
+		bool get_annotation_bool_from_texture_variable(effect_texture_variable variable, const char *name, bool *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_float_from_texture_variable(effect_texture_variable variable, const char *name, float *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_int_from_texture_variable(effect_texture_variable variable, const char *name, int32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_uint_from_texture_variable(effect_texture_variable variable, const char *name, uint32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_string_from_texture_variable(effect_texture_variable variable, const char *name, char *value, size_t *length) const override { return {}; }
+		void update_texture(effect_texture_variable variable, const uint32_t width, const uint32_t height, const uint8_t *pixels) override { }
+		void get_texture_binding(effect_texture_variable variable, resource_view *out_srv, resource_view *out_srv_srgb) const override { }
+		void enumerate_techniques(const char *effect_name, void(*callback)(effect_runtime *runtime, effect_technique technique, void *user_data), void *user_data) override { }
+		effect_technique find_technique(const char *effect_name, const char *technique_name) override { return {}; }
+		void get_technique_name(effect_technique technique, char *name, size_t *length) const override { }
+		bool get_annotation_bool_from_technique(effect_technique technique, const char *name, bool *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_float_from_technique(effect_technique technique, const char *name, float *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_int_from_technique(effect_technique technique, const char *name, int32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_uint_from_technique(effect_technique technique, const char *name, uint32_t *values, size_t count, size_t array_index) const override { return {}; }
+		bool get_annotation_string_from_technique(effect_technique technique, const char *name, char *value, size_t *length) const override { return {}; }
+		bool get_technique_state(effect_technique technique) const override { return {}; }
+		void set_technique_state(effect_technique technique, bool enabled) override { }
+		bool get_preprocessor_definition(const char *name, char *value, size_t *length) const override { return {}; }
+		void set_preprocessor_definition(const char *name, const char *value) override { }
+
+	private:
+		device* _device;
+		std::array<bool, 256> _down = {};
+		std::array<bool, 256> _pressed = {};
+	};
+}
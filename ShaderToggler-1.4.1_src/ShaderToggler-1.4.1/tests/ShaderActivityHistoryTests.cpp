@@ -0,0 +1,254 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "ShaderActivityHistory.h"
+#include "TestSupport.h"
+#include <initializer_list>
+#include <vector>
+
+using namespace ShaderToggler;
+
+namespace
+{
+	const size_t LargeMemoryBudget = 1 << 20;
+
+	std::vector<uint64_t> activeBits(std::initializer_list<uint32_t> denseIndices, size_t words = 1)
+	{
+		std::vector<uint64_t> bits(words, 0);
+		for (const uint32_t denseIndex : denseIndices)
+		{
+			bits[denseIndex / 64] |= uint64_t(1) << (denseIndex % 64);
+		}
+		return bits;
+	}
+
+	std::vector<uint32_t> activatedBetween(const ShaderActivityHistory& history, uint32_t frame, uint32_t baselineFrame)
+	{
+		std::vector<uint32_t> denseIndices;
+		history.collectActivatedBetween(frame, baselineFrame, denseIndices);
+		return denseIndices;
+	}
+
+	void testEmptyHistoryFindsNothing()
+	{
+		ShaderActivityHistory history(10, LargeMemoryBudget);
+		std::vector<uint32_t> denseIndices = { 1 };
+		CHECK(history.isEmpty());
+		CHECK(!history.collectActivatedBetween(0, 0, denseIndices));
+		CHECK(denseIndices.empty());
+	}
+
+	void testFramesOutsideTheWindowExpire()
+	{
+		ShaderActivityHistory history(10, LargeMemoryBudget);
+		for (uint32_t frame = 0; frame < 20; ++frame)
+		{
+			history.commitFrame(frame, activeBits({ frame % 2 }));
+		}
+
+		CHECK(history.getOldestFrame() == 10);
+		CHECK(history.getNewestFrame() == 19);
+		CHECK(history.getRecordCount() == 10);
+
+		std::vector<uint32_t> denseIndices;
+		CHECK(!history.collectActivatedBetween(19, 9, denseIndices));
+		CHECK(!history.collectActivatedBetween(9, 19, denseIndices));
+		CHECK(history.collectActivatedBetween(19, 10, denseIndices));
+		CHECK((denseIndices == std::vector<uint32_t>{ 1 }));
+	}
+
+	void testUnchangedFramesShareARecord()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		for (uint32_t frame = 0; frame < 50; ++frame)
+		{
+			history.commitFrame(frame, activeBits({ 3 }));
+		}
+		history.commitFrame(50, activeBits({ 3, 4 }));
+
+		CHECK(history.getRecordCount() == 2);
+		CHECK(history.getOldestFrame() == 0);
+		CHECK(history.getNewestFrame() == 50);
+		CHECK((activatedBetween(history, 50, 25) == std::vector<uint32_t>{ 4 }));
+		CHECK(activatedBetween(history, 25, 0).empty());
+	}
+
+	void testALongRunIsClippedToTheWindow()
+	{
+		ShaderActivityHistory history(10, LargeMemoryBudget);
+		for (uint32_t frame = 0; frame < 30; ++frame)
+		{
+			history.commitFrame(frame, activeBits({ 7 }));
+		}
+
+		CHECK(history.getRecordCount() == 1);
+		CHECK(history.getOldestFrame() == 20);
+		CHECK(history.getNewestFrame() == 29);
+
+		std::vector<uint32_t> denseIndices;
+		CHECK(!history.collectActivatedBetween(29, 19, denseIndices));
+		CHECK(history.collectActivatedBetween(29, 20, denseIndices));
+	}
+
+	void testFramesResolveToTheRecordCoveringThem()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(0, activeBits({ 0 }));
+		history.commitFrame(10, activeBits({ 0, 1 }));
+		history.commitFrame(20, activeBits({ 0, 1, 2 }));
+		history.commitFrame(30, activeBits({ 2 }));
+
+		// each frame up to the next commit belongs to the record committed before it.
+		CHECK((activatedBetween(history, 30, 0) == std::vector<uint32_t>{ 2 }));
+		CHECK((activatedBetween(history, 25, 5) == std::vector<uint32_t>{ 1, 2 }));
+		CHECK((activatedBetween(history, 19, 9) == std::vector<uint32_t>{ 1 }));
+		CHECK(activatedBetween(history, 9, 0).empty());
+		CHECK((activatedBetween(history, 20, 30) == std::vector<uint32_t>{ 0, 1 }));
+	}
+
+	void testActivatedShadersComeInDenseIndexOrder()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(0, activeBits({ 5 }, 3));
+		history.commitFrame(1, activeBits({ 150, 5, 64, 2, 63 }, 3));
+
+		CHECK((activatedBetween(history, 1, 0) == std::vector<uint32_t>{ 2, 63, 64, 150 }));
+	}
+
+	void testRepeatedFrameEpochIsIgnored()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(4, activeBits({ 1 }));
+		history.commitFrame(4, activeBits({ 2 }));
+
+		CHECK(history.getRecordCount() == 1);
+		CHECK((activatedBetween(history, 4, 4).empty()));
+		history.commitFrame(5, activeBits({ 1, 2 }));
+		CHECK((activatedBetween(history, 5, 4) == std::vector<uint32_t>{ 2 }));
+	}
+
+	void testFrameEpochWrapAround()
+	{
+		ShaderActivityHistory history(10, LargeMemoryBudget);
+		const uint32_t firstFrame = 0xFFFFFFFCu;
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			history.commitFrame(firstFrame + i, activeBits({ i }));
+		}
+
+		CHECK(history.getOldestFrame() == firstFrame);
+		CHECK(history.getNewestFrame() == 3);
+		CHECK((activatedBetween(history, 1, firstFrame) == std::vector<uint32_t>{ 5 }));
+		CHECK((activatedBetween(history, 0xFFFFFFFFu, 2) == std::vector<uint32_t>{ 3 }));
+	}
+
+	void testMemoryBudgetLimitsTheRecords()
+	{
+		// the ring starts out with 16 words per frame: 136 bytes per record, four records fit.
+		ShaderActivityHistory history(100, 4 * (16 * sizeof(uint64_t) + 2 * sizeof(uint32_t)));
+		for (uint32_t frame = 0; frame < 10; ++frame)
+		{
+			history.commitFrame(frame, activeBits({ frame }));
+		}
+
+		CHECK(history.getRecordCapacity() == 4);
+		CHECK(history.getRecordCount() == 4);
+		CHECK(history.getOldestFrame() == 6);
+		CHECK(history.getNewestFrame() == 9);
+		CHECK((activatedBetween(history, 9, 6) == std::vector<uint32_t>{ 9 }));
+	}
+
+	void testGrowingTheShaderCountKeepsTheNewestRecords()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(0, activeBits({ 1 }));
+		history.commitFrame(1, activeBits({ 1, 2 }));
+		const uint32_t capacity = history.getRecordCapacity();
+
+		history.commitFrame(2, activeBits({ 2, 1500 }, 24));
+
+		CHECK(history.getRecordCapacity() <= capacity);
+		CHECK(history.getRecordCount() == 3);
+		CHECK((activatedBetween(history, 2, 0) == std::vector<uint32_t>{ 2, 1500 }));
+		CHECK((activatedBetween(history, 1, 0) == std::vector<uint32_t>{ 2 }));
+	}
+
+	void testFrozenHistoryIgnoresCommits()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(0, activeBits({ 1 }));
+		history.setFrozen(true);
+		history.commitFrame(1, activeBits({ 2 }));
+
+		CHECK(history.getNewestFrame() == 0);
+		CHECK(history.getRecordCount() == 1);
+
+		history.setFrozen(false);
+		history.commitFrame(1, activeBits({ 2 }));
+		CHECK(history.getNewestFrame() == 1);
+	}
+
+	void testClearEmptiesTheHistory()
+	{
+		ShaderActivityHistory history(100, LargeMemoryBudget);
+		history.commitFrame(0, activeBits({ 1 }));
+		history.commitFrame(1, activeBits({ 2 }));
+		history.clear();
+
+		CHECK(history.isEmpty());
+		history.commitFrame(2, activeBits({ 3 }));
+		CHECK(history.getOldestFrame() == 2);
+		CHECK(history.getRecordCount() == 1);
+	}
+}
+
+int main()
+{
+	testEmptyHistoryFindsNothing();
+	testFramesOutsideTheWindowExpire();
+	testUnchangedFramesShareARecord();
+	testALongRunIsClippedToTheWindow();
+	testFramesResolveToTheRecordCoveringThem();
+	testActivatedShadersComeInDenseIndexOrder();
+	testRepeatedFrameEpochIsIgnored();
+	testFrameEpochWrapAround();
+	testMemoryBudgetLimitsTheRecords();
+	testGrowingTheShaderCountKeepsTheNewestRecords();
+	testFrozenHistoryIgnoresCommits();
+	testClearEmptiesTheHistory();
+	return ShaderTogglerTests::finishTests("ShaderActivityHistoryTests");
+}
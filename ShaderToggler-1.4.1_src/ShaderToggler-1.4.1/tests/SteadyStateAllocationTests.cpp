@@ -0,0 +1,266 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// Drives Main.cpp's bind_pipeline, draw and present callbacks through the ReShade stubs, the way a game's frames
+// would, and fails if any of them allocates once the configuration has settled. Built with _DEBUG, so
+// AllocationCounter counts every operator new on this thread.
+
+#include "AllocationCounter.h"
+#include "CDataFile.h"
+#include "ReShadeStubs.h"
+#include "TestSupport.h"
+#include "ToggleGroup.h"
+#include "crc32_hash.hpp"
+#include <chrono>
+#include <filesystem>
+#include <unistd.h>
+
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID);
+
+using namespace ShaderToggler;
+using namespace ShaderTogglerTests;
+using reshade::addon_event;
+
+namespace
+{
+	constexpr uint8_t ToggleKey = 0x74; // VK_F5
+
+	// past the repair save's 500 ms debounce and the INI poll after it, which run once the first present starts them.
+	constexpr std::chrono::milliseconds SettleDuration(1500);
+	// longer than the 1 s INI poll interval, so at least one poll is measured too.
+	constexpr std::chrono::milliseconds MeasuredDuration(1200);
+	// longer than the add-on's 150 ms between two toggles of a group.
+	constexpr std::chrono::milliseconds HotkeyDebounceDuration(200);
+
+	const uint8_t BlockedPixelShaderCode[] = { 'D', 'X', 'B', 'C', 1, 2, 3, 4 };
+	const uint8_t VertexShaderCode[] = { 'D', 'X', 'B', 'C', 5, 6, 7, 8 };
+	const uint8_t OtherPixelShaderCode[] = { 'D', 'X', 'B', 'C', 9, 10, 11, 12 };
+
+	uint32_t hashOf(const uint8_t* code, size_t size)
+	{
+		return compute_crc32(code, size);
+	}
+
+	// One group, active at startup, that blocks the first pixel shader and toggles on F5. The file is written
+	// without the add-on's creator stamp, so loading it also goes through the repair save.
+	void writeIniFile(const std::filesystem::path& fileName)
+	{
+		ToggleGroup group("Blocked", 0);
+		group.storeCollectedHashes({ hashOf(BlockedPixelShaderCode, sizeof(BlockedPixelShaderCode)) }, {}, {});
+		group.setToggleKey(ToggleKey);
+		group.setIsActiveAtStartup(true);
+
+		CDataFile iniFile;
+		iniFile.SetInt("GTAmountGroups", 1, "", "General");
+		iniFile.SetInt("GTGroupFormat", ToggleGroup::PackedHashFormat, "", "General");
+		group.saveState(iniFile, 0, true);
+		iniFile.SetFileName(fileName);
+		CHECK(iniFile.Save());
+		iniFile.Clear();
+	}
+
+	struct AddonCallbacks
+	{
+		reshade::addon_event_traits<addon_event::init_device>::decl initDevice = reshade::stub::get_event_callback<addon_event::init_device>();
+		reshade::addon_event_traits<addon_event::destroy_device>::decl destroyDevice = reshade::stub::get_event_callback<addon_event::destroy_device>();
+		reshade::addon_event_traits<addon_event::init_command_list>::decl initCommandList = reshade::stub::get_event_callback<addon_event::init_command_list>();
+		reshade::addon_event_traits<addon_event::destroy_command_list>::decl destroyCommandList = reshade::stub::get_event_callback<addon_event::destroy_command_list>();
+		reshade::addon_event_traits<addon_event::init_pipeline>::decl initPipeline = reshade::stub::get_event_callback<addon_event::init_pipeline>();
+		reshade::addon_event_traits<addon_event::destroy_pipeline>::decl destroyPipeline = reshade::stub::get_event_callback<addon_event::destroy_pipeline>();
+		reshade::addon_event_traits<addon_event::bind_pipeline>::decl bindPipeline = reshade::stub::get_event_callback<addon_event::bind_pipeline>();
+		reshade::addon_event_traits<addon_event::draw>::decl draw = reshade::stub::get_event_callback<addon_event::draw>();
+		reshade::addon_event_traits<addon_event::draw_indexed>::decl drawIndexed = reshade::stub::get_event_callback<addon_event::draw_indexed>();
+		reshade::addon_event_traits<addon_event::reshade_present>::decl present = reshade::stub::get_event_callback<addon_event::reshade_present>();
+		reshade::addon_event_traits<addon_event::destroy_effect_runtime>::decl destroyEffectRuntime = reshade::stub::get_event_callback<addon_event::destroy_effect_runtime>();
+
+		bool allRegistered() const
+		{
+			return initDevice && destroyDevice && initCommandList && destroyCommandList && initPipeline && destroyPipeline &&
+				bindPipeline && draw && drawIndexed && present && destroyEffectRuntime;
+		}
+	};
+
+	struct FrameResult
+	{
+		bool blockedShaderDrawBlocked = false;
+		bool otherShaderDrawBlocked = false;
+		uint32_t bindPipelineAllocations = 0;
+		uint32_t drawAllocations = 0;
+		uint32_t presentAllocations = 0;
+	};
+
+	template <typename Call>
+	uint32_t countAllocations(Call&& call)
+	{
+		const ScopedAllocationCounter counter;
+		call();
+		return counter.getCount();
+	}
+
+	// A frame binds both pipelines, draws with each (twice with the second, which hits the cached verdict) and presents.
+	FrameResult runFrame(const AddonCallbacks& callbacks, StubCommandList& commandList, StubEffectRuntime& runtime, pipeline blockedPipeline, pipeline otherPipeline)
+	{
+		FrameResult result;
+		result.bindPipelineAllocations += countAllocations([&] { callbacks.bindPipeline(&commandList, pipeline_stage::all_graphics, blockedPipeline); });
+		result.drawAllocations += countAllocations([&] { result.blockedShaderDrawBlocked = callbacks.drawIndexed(&commandList, 36, 1, 0, 0, 0); });
+		result.bindPipelineAllocations += countAllocations([&] { callbacks.bindPipeline(&commandList, pipeline_stage::pixel_shader, otherPipeline); });
+		result.drawAllocations += countAllocations([&] { result.otherShaderDrawBlocked = callbacks.draw(&commandList, 3, 1, 0, 0); });
+		result.drawAllocations += countAllocations([&] { callbacks.draw(&commandList, 3, 1, 0, 0); });
+		result.presentAllocations += countAllocations([&] { callbacks.present(&runtime); });
+		runtime.endFrame();
+		return result;
+	}
+
+	void runFramesFor(std::chrono::milliseconds duration, const AddonCallbacks& callbacks, StubCommandList& commandList, StubEffectRuntime& runtime, pipeline blockedPipeline, pipeline otherPipeline)
+	{
+		const auto end = std::chrono::steady_clock::now() + duration;
+		while (std::chrono::steady_clock::now() < end)
+		{
+			runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		}
+	}
+
+	void pressToggleKey(const AddonCallbacks& callbacks, StubCommandList& commandList, StubEffectRuntime& runtime, pipeline blockedPipeline, pipeline otherPipeline)
+	{
+		runtime.setKeyDown(ToggleKey, true);
+		runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		runtime.setKeyDown(ToggleKey, false);
+	}
+
+	void testSteadyStateFramesDoNotAllocate()
+	{
+		// the add-on falls back to ShaderToggler.ini in the working directory; a fresh one keeps the runs apart.
+		char directoryTemplate[] = "/tmp/ShaderTogglerAllocationXXXXXX";
+		CHECK(mkdtemp(directoryTemplate) != nullptr);
+		const std::filesystem::path directory = directoryTemplate;
+		const std::filesystem::path previousDirectory = std::filesystem::current_path();
+		std::filesystem::current_path(directory);
+		writeIniFile("ShaderToggler.ini");
+
+		int moduleAnchor = 0;
+		const HMODULE module = &moduleAnchor;
+		CHECK(DllMain(module, DLL_PROCESS_ATTACH, nullptr) == TRUE);
+
+		const AddonCallbacks callbacks;
+		CHECK(callbacks.allRegistered());
+		if (!callbacks.allRegistered())
+		{
+			return;
+		}
+
+		StubDevice device;
+		StubCommandList commandList(&device);
+		StubEffectRuntime runtime(&device);
+		callbacks.initDevice(&device);
+		callbacks.initCommandList(&commandList);
+
+		shader_desc blockedPixelShader = {};
+		blockedPixelShader.code = BlockedPixelShaderCode;
+		blockedPixelShader.code_size = sizeof(BlockedPixelShaderCode);
+		shader_desc vertexShader = {};
+		vertexShader.code = VertexShaderCode;
+		vertexShader.code_size = sizeof(VertexShaderCode);
+		shader_desc otherPixelShader = {};
+		otherPixelShader.code = OtherPixelShaderCode;
+		otherPixelShader.code_size = sizeof(OtherPixelShaderCode);
+
+		const pipeline blockedPipeline = { 0x1000 };
+		const pipeline otherPipeline = { 0x2000 };
+		const pipeline_subobject blockedSubobjects[] = {
+			{ pipeline_subobject_type::vertex_shader, 1, &vertexShader },
+			{ pipeline_subobject_type::pixel_shader, 1, &blockedPixelShader } };
+		const pipeline_subobject otherSubobjects[] = {
+			{ pipeline_subobject_type::pixel_shader, 1, &otherPixelShader } };
+		callbacks.initPipeline(&device, {}, 2, blockedSubobjects, blockedPipeline);
+		callbacks.initPipeline(&device, {}, 1, otherSubobjects, otherPipeline);
+
+		// the first present finishes the deferred init, which loads the INI, and starts the persistence worker.
+		runFramesFor(SettleDuration, callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+
+		FrameResult frame = runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		CHECK(frame.blockedShaderDrawBlocked);
+		CHECK(!frame.otherShaderDrawBlocked);
+
+		// the hotkey reaches the group: F5 turns it off, and on again once the hotkey debounce has passed.
+		pressToggleKey(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		frame = runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		CHECK(!frame.blockedShaderDrawBlocked);
+		runFramesFor(HotkeyDebounceDuration, callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		pressToggleKey(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+		// the release is a group update as well.
+		runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+
+		FrameResult total;
+		uint32_t frameCount = 0;
+		uint32_t wrongVerdicts = 0;
+		const auto end = std::chrono::steady_clock::now() + MeasuredDuration;
+		while (std::chrono::steady_clock::now() < end)
+		{
+			frame = runFrame(callbacks, commandList, runtime, blockedPipeline, otherPipeline);
+			wrongVerdicts += frame.blockedShaderDrawBlocked && !frame.otherShaderDrawBlocked ? 0 : 1;
+			total.bindPipelineAllocations += frame.bindPipelineAllocations;
+			total.drawAllocations += frame.drawAllocations;
+			total.presentAllocations += frame.presentAllocations;
+			++frameCount;
+		}
+
+		std::printf("%u steady frames: %u allocation(s) in bind_pipeline, %u in draw, %u in reshade_present\n",
+			frameCount, total.bindPipelineAllocations, total.drawAllocations, total.presentAllocations);
+		CHECK(wrongVerdicts == 0);
+		CHECK(total.bindPipelineAllocations == 0);
+		CHECK(total.drawAllocations == 0);
+		CHECK(total.presentAllocations == 0);
+		CHECK(reshade::stub::get_registry().warnings_logged == 0);
+
+		callbacks.destroyEffectRuntime(&runtime);
+		callbacks.destroyPipeline(&device, otherPipeline);
+		callbacks.destroyPipeline(&device, blockedPipeline);
+		callbacks.destroyCommandList(&commandList);
+		callbacks.destroyDevice(&device);
+		CHECK(DllMain(module, DLL_PROCESS_DETACH, nullptr) == TRUE);
+
+		std::filesystem::current_path(previousDirectory);
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
+
+int main()
+{
+	testSteadyStateFramesDoNotAllocate();
+	return finishTests("SteadyStateAllocationTests");
+}
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// Minimal checks shared by the tests: a failed CHECK reports the expression and the test keeps going, so one
+// run lists every failure. finishTests() turns the count into the exit code for make.
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace ShaderTogglerTests
+{
+	inline int& failureCount()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline int finishTests(const char* name)
+	{
+		if (failureCount() != 0)
+		{
+			std::fprintf(stderr, "%s: %d check(s) failed\n", name, failureCount());
+			return 1;
+		}
+
+		std::printf("%s: all checks passed\n", name);
+		return 0;
+	}
+
+	// Average wall time per call of body over the given number of iterations, in nanoseconds.
+	template <typename Body>
+	double measureNsPerIteration(int iterations, Body&& body)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			body(i);
+		}
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+	}
+}
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+			++ShaderTogglerTests::failureCount(); \
+		} \
+	} while (false)
@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// Time for ToggleGroup::loadState to read the hashes of every group of a large config: the packed layout, one
+// comma separated list per stage, against the per-key layout it replaced, one ShaderHash<n> key per hash. Both
+// configs hold the same hashes. The INI is loaded up front, so only the group reads are timed.
+
+#include "CDataFile.h"
+#include "LargeConfig.h"
+#include "TestSupport.h"
+#include "ToggleGroup.h"
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+using namespace ShaderToggler;
+using namespace ShaderTogglerTests;
+
+namespace
+{
+	constexpr int Iterations = 5;
+	constexpr size_t GroupCount = 400;
+
+	// Parses text the way CDataFile::Load does once the file is read.
+	class BufferDataFile : public CDataFile
+	{
+	public:
+		explicit BufferDataFile(std::string_view text) { ParseBuffer(text); }
+		~BufferDataFile() override { Clear(); }
+	};
+
+	void runLayout(const char* name, const std::string& text, int hashFormat, size_t hashesPerStage)
+	{
+		BufferDataFile iniFile(text);
+		std::vector<ToggleGroup> groups(GroupCount, ToggleGroup("", 0));
+
+		const double ns = measureNsPerIteration(Iterations, [&](int)
+			{
+				for (size_t i = 0; i < groups.size(); ++i)
+					groups[i].loadState(iniFile, static_cast<int>(i), true, hashFormat);
+			});
+
+		size_t loadedHashes = 0;
+		for (const ToggleGroup& group : groups)
+			loadedHashes += group.getVertexShaderHashes().size() + group.getPixelShaderHashes().size() + group.getComputeShaderHashes().size();
+
+		const size_t expectedHashes = GroupCount * 3 * hashesPerStage;
+		std::printf("%10s %8.1f %10zu %12.1f %12.1f%s\n", name, text.size() / (1024.0 * 1024.0), loadedHashes,
+			ns / 1e6, ns / static_cast<double>(expectedHashes), loadedHashes == expectedHashes ? "" : "  (hashes missing!)");
+	}
+}
+
+int main()
+{
+	std::printf("%10s %8s %10s %12s %12s\n", "layout", "MB", "hashes", "load ms", "ns/hash");
+	for (const size_t hashesPerStage : { 350u, 900u })
+	{
+		runLayout("packed", LargeConfig::makePacked(GroupCount, hashesPerStage), ToggleGroup::PackedHashFormat, hashesPerStage);
+		runLayout("per-key", LargeConfig::makePerKey(GroupCount, hashesPerStage), ToggleGroup::LegacyHashFormat, hashesPerStage);
+	}
+	return 0;
+}
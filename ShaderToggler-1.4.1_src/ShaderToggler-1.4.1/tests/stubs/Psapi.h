@@ -0,0 +1,4 @@
+// Stand-in; see windows.h.
+#pragma once
+
+#include "windows.h"
@@ -0,0 +1,10 @@
+// Stand-in for the configuration manager header; see windows.h. Reports no devices.
+#pragma once
+
+#include "windows.h"
+
+#define CR_SUCCESS 0
+#define CM_GETIDLIST_FILTER_PRESENT 0x00000100
+
+inline int CM_Get_Device_ID_List_SizeW(ULONG* length, const wchar_t*, ULONG) { *length = 0; return 1; }
+inline int CM_Get_Device_ID_ListW(const wchar_t*, wchar_t*, ULONG, ULONG) { return 1; }
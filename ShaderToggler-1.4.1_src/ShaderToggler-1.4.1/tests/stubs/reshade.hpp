@@ -0,0 +1,84 @@
+// Stand-in for ReShade's reshade.hpp, for the Linux harness that drives Main.cpp's event callbacks. It keeps the
+// real API, event and overlay headers, but instead of looking up the ReShade module it records what the add-on
+// registers, so the harness can call the callbacks itself. The real header can't be used with GCC anyway: it
+// static_casts function pointers to void*. Dear ImGui isn't available, so the overlay must not be drawn.
+#pragma once
+
+#include "reshade_events.hpp"
+#include "reshade_overlay.hpp"
+#include <windows.h>
+#include <cstdio>
+
+#define RESHADE_API_VERSION 2
+
+namespace reshade
+{
+	namespace stub
+	{
+		// addon_event::max only exists when building ReShade itself.
+		constexpr size_t event_count = static_cast<size_t>(addon_event::reshade_overlay) + 1;
+
+		struct registry
+		{
+			bool addon_registered = false;
+			void* event_callbacks[event_count] = {};
+			void(*overlay_callback)(api::effect_runtime* runtime) = nullptr;
+			uint32_t warnings_logged = 0;
+		};
+
+		inline registry& get_registry()
+		{
+			static registry instance;
+			return instance;
+		}
+
+		template <addon_event ev>
+		inline typename addon_event_traits<ev>::decl get_event_callback()
+		{
+			return reinterpret_cast<typename addon_event_traits<ev>::decl>(get_registry().event_callbacks[static_cast<size_t>(ev)]);
+		}
+	}
+
+	inline void log_message(int level, const char* message)
+	{
+		// errors and warnings; info messages are expected.
+		if (level <= 2)
+		{
+			++stub::get_registry().warnings_logged;
+			std::fprintf(stderr, "reshade log: %s\n", message);
+		}
+	}
+
+	inline bool register_addon(HMODULE)
+	{
+		stub::get_registry().addon_registered = true;
+		return true;
+	}
+	inline void unregister_addon(HMODULE)
+	{
+		stub::get_registry().addon_registered = false;
+	}
+
+	template <addon_event ev>
+	inline void register_event(typename addon_event_traits<ev>::decl callback)
+	{
+		stub::get_registry().event_callbacks[static_cast<size_t>(ev)] = reinterpret_cast<void*>(callback);
+	}
+	template <addon_event ev>
+	inline void unregister_event(typename addon_event_traits<ev>::decl callback)
+	{
+		void*& registered = stub::get_registry().event_callbacks[static_cast<size_t>(ev)];
+		if (registered == reinterpret_cast<void*>(callback))
+			registered = nullptr;
+	}
+
+	inline void register_overlay(const char*, void(*callback)(api::effect_runtime* runtime))
+	{
+		stub::get_registry().overlay_callback = callback;
+	}
+	inline void unregister_overlay(const char*, void(*callback)(api::effect_runtime* runtime))
+	{
+		if (stub::get_registry().overlay_callback == callback)
+			stub::get_registry().overlay_callback = nullptr;
+	}
+}
@@ -0,0 +1,112 @@
+// Stand-in for the parts of the Windows SDK the add-on's sources use, so they build on Linux for the tests and
+// benchmarks. Force-included ahead of every source (see STUB_CXXFLAGS in ../Makefile), because the ReShade
+// headers rely on MSVC keywords before anything includes <Windows.h>. Functions do nothing: no keys are down,
+// no controller is connected, no module can be loaded.
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <strings.h>
+
+#define __declspec(x)
+#define WINAPI
+#define APIENTRY
+#define CALLBACK
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef unsigned long DWORD;
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef int64_t LONGLONG;
+typedef wchar_t WCHAR;
+typedef const wchar_t* LPCWSTR;
+typedef void* LPVOID;
+typedef void* HANDLE;
+typedef void* HMODULE;
+typedef void* FARPROC;
+typedef DWORD* LPDWORD;
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID);
+
+#define TRUE 1
+#define FALSE 0
+#define MAX_PATH 260
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define ERROR_SUCCESS 0
+#define CP_UTF8 65001
+#define _TRUNCATE ((size_t)-1)
+
+#define DLL_PROCESS_DETACH 0
+#define DLL_PROCESS_ATTACH 1
+#define GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS 0x4
+
+#define VK_LBUTTON 0x01
+#define VK_RBUTTON 0x02
+#define VK_MBUTTON 0x04
+#define VK_XBUTTON1 0x05
+#define VK_XBUTTON2 0x06
+#define VK_BACK 0x08
+#define VK_SHIFT 0x10
+#define VK_CONTROL 0x11
+#define VK_MENU 0x12
+#define VK_CAPITAL 0x14
+#define VK_PRIOR 0x21
+#define VK_NEXT 0x22
+#define VK_END 0x23
+#define VK_LEFT 0x25
+#define VK_UP 0x26
+#define VK_RIGHT 0x27
+#define VK_DOWN 0x28
+#define VK_INSERT 0x2D
+#define VK_DELETE 0x2E
+#define VK_NUMPAD0 0x60
+#define VK_NUMPAD1 0x61
+#define VK_NUMPAD2 0x62
+#define VK_NUMPAD3 0x63
+#define VK_NUMPAD4 0x64
+#define VK_NUMPAD5 0x65
+#define VK_NUMPAD6 0x66
+#define VK_NUMPAD7 0x67
+#define VK_NUMPAD8 0x68
+#define VK_NUMPAD9 0x69
+#define VK_MULTIPLY 0x6A
+#define VK_ADD 0x6B
+#define VK_SUBTRACT 0x6D
+#define VK_DECIMAL 0x6E
+#define VK_DIVIDE 0x6F
+
+// __uuidof only has to give every type its own stable address.
+struct StubGuid { unsigned char bytes[16]; };
+template <typename T> inline const StubGuid& stubUuidOf() { static const StubGuid guid = {}; return guid; }
+#define __uuidof(T) (stubUuidOf<T>())
+
+inline short GetAsyncKeyState(int) { return 0; }
+inline DWORD GetTickCount() { return 0; }
+inline void ZeroMemory(void* destination, size_t length) { std::memset(destination, 0, length); }
+inline int WideCharToMultiByte(unsigned, DWORD, const wchar_t*, int, char*, int, void*, void*) { return 0; }
+template <size_t N> inline int strncpy_s(char (&destination)[N], const char* source, size_t)
+{
+	std::strncpy(destination, source, N - 1);
+	destination[N - 1] = 0;
+	return 0;
+}
+template <size_t N> inline int strncpy_s(char (&destination)[N], size_t, const char* source, size_t count)
+{
+	return strncpy_s(destination, source, count);
+}
+
+inline DWORD GetModuleFileNameW(HMODULE, WCHAR*, DWORD) { return 0; }
+inline HMODULE GetModuleHandleW(const wchar_t*) { return nullptr; }
+inline BOOL GetModuleHandleExW(DWORD, const wchar_t*, HMODULE*) { return FALSE; }
+inline HMODULE LoadLibraryW(const wchar_t*) { return nullptr; }
+inline FARPROC GetProcAddress(HMODULE, const char*) { return nullptr; }
+inline BOOL FreeLibrary(HMODULE) { return TRUE; }
+inline HANDLE GetCurrentProcess() { return nullptr; }
+extern "C" inline BOOL K32EnumProcessModules(HANDLE, HMODULE*, DWORD, DWORD*) { return FALSE; }
+
+inline HANDLE CreateThread(void*, size_t, LPTHREAD_START_ROUTINE, LPVOID, DWORD, DWORD*) { return nullptr; }
+[[noreturn]] inline void FreeLibraryAndExitThread(HMODULE, DWORD) { __builtin_trap(); }
+inline BOOL CloseHandle(HANDLE) { return TRUE; }
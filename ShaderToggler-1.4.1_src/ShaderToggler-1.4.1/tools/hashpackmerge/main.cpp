@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of ShaderToggler Advanced – A shader toggler add-on for ReShade 5+
+// which allows you to define groups of shaders to toggle them on/off 
+// with one key press.
+//
+// Based on the original ShaderToggler by Frans 'Otis_Inf' Bouma.
+// (c) Frans 'Otis_Inf' Bouma. All rights reserved.
+//
+// https://github.com/FransBouma/ShaderToggler
+//
+// Modifications
+// (c) 2026 Sven 'Gametism' Koenigsmann. All rights reserved.
+// 
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notices,
+//    this list of conditions, and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notices,
+//    this list of conditions, and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+// hashpackmerge: merges hash packs into a ShaderToggler.ini without a game or ReShade running, for batch
+// processing of packs on any platform.
+//
+//   hashpackmerge [--union | --intersect | --replace] [--dry-run] <target.ini> <pack.ini>...
+//
+// The packs are merged into the target in the order given; the target is created if it doesn't exist.
+
+#include "CDataFile.h"
+#include "HashPackMerge.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace ShaderToggler;
+
+static int printUsage()
+{
+	std::fprintf(stderr,
+		"usage: hashpackmerge [--union | --intersect | --replace] [--dry-run] <target.ini> <pack.ini>...\n"
+		"  --union      add the pack's hashes to groups of the same name, add missing groups (default)\n"
+		"  --intersect  keep only the hashes a group shares with the pack's group of the same name\n"
+		"  --replace    take the pack's hashes for groups of the same name, add missing groups\n"
+		"  --dry-run    print the report without writing the target\n");
+	return 2;
+}
+
+int main(int argc, char* argv[])
+{
+	HashPackMergeMode mode = HashPackMergeMode::Union;
+	bool dryRun = false;
+	std::vector<std::filesystem::path> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--union") == 0)
+			mode = HashPackMergeMode::Union;
+		else if (std::strcmp(argv[i], "--intersect") == 0)
+			mode = HashPackMergeMode::Intersection;
+		else if (std::strcmp(argv[i], "--replace") == 0)
+			mode = HashPackMergeMode::Replace;
+		else if (std::strcmp(argv[i], "--dry-run") == 0)
+			dryRun = true;
+		else if (argv[i][0] == '-')
+			return printUsage();
+		else
+			files.emplace_back(argv[i]);
+	}
+
+	if (files.size() < 2)
+		return printUsage();
+
+	const std::filesystem::path& targetFileName = files[0];
+	CDataFile targetFile;
+	HashPack target;
+	if (std::filesystem::exists(targetFileName) && (!targetFile.Load(targetFileName) || !HashPackMerge::read(targetFile, target)))
+	{
+		std::fprintf(stderr, "%s: no groups found\n", targetFileName.string().c_str());
+		targetFile.Clear();
+		return 1;
+	}
+
+	HashPackMergeReport total;
+	for (size_t i = 1; i < files.size(); ++i)
+	{
+		CDataFile packFile;
+		HashPack pack;
+		const bool loaded = packFile.Load(files[i]) && HashPackMerge::read(packFile, pack);
+		// only read; clearing it keeps its destructor from saving it.
+		packFile.Clear();
+		if (!loaded)
+		{
+			std::fprintf(stderr, "%s: could not be read or has no groups\n", files[i].string().c_str());
+			targetFile.Clear();
+			return 1;
+		}
+
+		const HashPackMergeReport report = HashPackMerge::merge(target, pack, mode);
+		std::printf("%s: %s\n", files[i].string().c_str(), report.toString().c_str());
+		total.add(report);
+	}
+
+	std::printf("%s (%s): %s\n", targetFileName.string().c_str(), HashPackMerge::getModeName(mode), total.toString().c_str());
+
+	bool saved = true;
+	if (!dryRun)
+	{
+		HashPackMerge::write(targetFile, target);
+		targetFile.SetFileName(targetFileName);
+		saved = targetFile.Save();
+		if (!saved)
+			std::fprintf(stderr, "%s: could not be written\n", targetFileName.string().c_str());
+	}
+
+	targetFile.Clear();
+	return saved ? 0 : 1;
+}